@@ -0,0 +1,274 @@
+#pragma once
+
+#include <iostream>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Exceptions.h"
+#include "OrderedSet.h"
+
+// ordered set for many small sets, up to ARRAY_LIMIT elements they are kept in sorted arrays (one binary search and
+// a memmove per add), bigger ones are moved to an OrderedSet and back to arrays once they shrink to half of the limit
+template<class type, class Compare = HashOrder> class AdaptiveOrderedSet {
+    static constexpr bool HASH_ORDERED = std::is_same<Compare, HashOrder>::value;
+    static constexpr size_t ARRAY_LIMIT = 64;
+
+    using Tree = OrderedSet<type, Compare>;
+
+    std::vector<size_t> keys; // only for HashOrder, same order as values
+    std::vector<type> values; // empty while the elements are in tree
+    Tree tree;
+    bool inTree;
+public:
+    explicit AdaptiveOrderedSet() : inTree(false) {};
+    // copies get their own tree, unlike copies of OrderedSet, so small and big sets behave the same
+    AdaptiveOrderedSet(const AdaptiveOrderedSet<type, Compare> &set) : keys(set.keys), values(set.values), inTree(set.inTree) {
+        if (inTree) {
+            tree.unionWith(set.tree);
+        }
+    };
+    AdaptiveOrderedSet<type, Compare> &operator=(AdaptiveOrderedSet<type, Compare> set) {
+        std::swap(keys, set.keys);
+        std::swap(values, set.values);
+        std::swap(tree, set.tree);
+        std::swap(inTree, set.inTree);
+        return *this;
+    };
+    ~AdaptiveOrderedSet() {
+        tree.destroy();
+    };
+
+    class Iterator {
+        friend AdaptiveOrderedSet<type, Compare>;
+
+        AdaptiveOrderedSet<type, Compare> *set;
+        size_t i; // position in the arrays
+        typename Tree::Cursor cursor;
+    public:
+        explicit Iterator(AdaptiveOrderedSet<type, Compare> *set) : set(set), i(0), cursor(set->tree) {};
+
+        void operator++() {
+            if (set->inTree) {
+                ++cursor;
+                return;
+            }
+            if (i >= set->values.size()) {
+                throw IndexOutOfRangeException();
+            }
+            i++;
+        };
+
+        type getData() {return set->inTree ? cursor.getNode()->getData() : set->values[i];}
+        bool finished() {return set->inTree ? cursor.finished() : i < set->values.size();};
+    };
+
+    friend Iterator;
+    Iterator getIterator() {
+        return Iterator(this);
+    }
+
+    void clear() {
+        tree.destroy();
+        keys.clear();
+        values.clear();
+        inTree = false;
+    };
+
+    template<typename... types>
+    void addMultiple(type value, types... values) {add(value); addMultiple(values...);};
+    void add(type value) { add(value, keyOf(value)); };
+    void add(type value, int key) {
+        if (inTree) {
+            tree.add(value, key);
+            return;
+        }
+        size_t i = lowerBound(value, key);
+        if (i < values.size() && same(i, value, key)) {
+            return;
+        }
+        if (values.size() == ARRAY_LIMIT) {
+            moveToTree();
+            tree.add(value, key);
+            return;
+        }
+        values.insert(values.begin() + i, value);
+        if constexpr (HASH_ORDERED) {
+            keys.insert(keys.begin() + i, size_t(key));
+        }
+    };
+
+    void remove(type value) { remove(value, keyOf(value)); };
+    void remove(type value, int key) {
+        if (inTree) {
+            tree.remove(value, key);
+            if (tree.getSize() <= ARRAY_LIMIT / 2) {
+                moveToArrays();
+            }
+            return;
+        }
+        size_t i = find(value, key);
+        values.erase(values.begin() + i);
+        if constexpr (HASH_ORDERED) {
+            keys.erase(keys.begin() + i);
+        }
+    };
+
+    bool contains(type value) { return contains(value, keyOf(value)); };
+    bool contains(type value, int key) {
+        if (inTree) {
+            return tree.contains(value, key);
+        }
+        size_t i = lowerBound(value, key);
+        return i < values.size() && same(i, value, key);
+    };
+
+    size_t getSize() {return inTree ? tree.getSize() : values.size();}
+    bool isTree() {return inTree;}
+    type min() {
+        if (inTree) {
+            return tree.min();
+        }
+        if (values.empty()) {
+            throw EmptySetException();
+        }
+        return values.front();
+    };
+    type max() {
+        if (inTree) {
+            return tree.max();
+        }
+        if (values.empty()) {
+            throw EmptySetException();
+        }
+        return values.back();
+    };
+    type *getSortedList() {
+        if (inTree) {
+            return tree.getSortedList();
+        }
+        type *listToReturn = new type[values.size()];
+        std::copy(values.begin(), values.end(), listToReturn);
+        return listToReturn;
+    };
+
+    // O(1) while the set is in arrays
+    type getItem(size_t index) {
+        if (inTree) {
+            return tree.getItem(index);
+        }
+        if (index >= values.size()) {
+            throw IndexOutOfRangeException();
+        }
+        return values[index];
+    };
+    size_t getIndex(type value) {return getIndex(value, keyOf(value));}
+    size_t getIndex(type value, int key) {
+        if (inTree) {
+            if (!tree.contains(value, key)) {
+                throw ValueNotFoundException();
+            }
+            return tree.getIndex(value, key);
+        }
+        return find(value, key);
+    };
+
+private:
+
+    void addMultiple() {};
+
+    // elements come sorted, so every add of the tree starts next to the previous one
+    void moveToTree() {
+        for (size_t i = 0; i < values.size(); i++) {
+            tree.add(values[i], HASH_ORDERED ? int(keys[i]) : 0);
+        }
+        keys.clear();
+        keys.shrink_to_fit();
+        values.clear();
+        values.shrink_to_fit();
+        inTree = true;
+    };
+
+    void moveToArrays() {
+        for (typename Tree::Cursor cursor(tree); cursor.finished(); ++cursor) {
+            values.push_back(cursor.getNode()->getData());
+            if constexpr (HASH_ORDERED) {
+                keys.push_back(cursor.getNode()->getKey());
+            }
+        }
+        tree.destroy(); // small again, the pool is not needed
+        inTree = false;
+    };
+
+    // branchless binary search, returns position of the first element >= value
+    size_t lowerBound(type &value, int key) {
+        size_t first = 0, length = values.size();
+        while (length > 1) {
+            size_t half = length / 2;
+            if constexpr (HASH_ORDERED) {
+                first += (keys[first + half - 1] < size_t(key)) ? half : 0;
+            } else {
+                first += Compare()(values[first + half - 1], value) ? half : 0;
+            }
+            length -= half;
+        }
+        if (length == 1) {
+            if constexpr (HASH_ORDERED) {
+                first += keys[first] < size_t(key);
+            } else {
+                first += Compare()(values[first], value);
+            }
+        }
+        return first;
+    };
+
+    bool same(size_t i, type &value, int key) {
+        if constexpr (HASH_ORDERED) {
+            return keys[i] == size_t(key);
+        } else {
+            return !Compare()(value, values[i]);
+        }
+    };
+
+    size_t find(type &value, int key) {
+        size_t i = lowerBound(value, key);
+        if (i == values.size() || !same(i, value, key)) {
+            throw ValueNotFoundException();
+        }
+        return i;
+    };
+
+    size_t keyOf(type &value) {
+        if constexpr (HASH_ORDERED) {
+            return hash(value);
+        } else {
+            return 0;
+        }
+    };
+
+    template <typename Integer,
+            std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+    size_t hash(Integer &key) { return key; };
+    template <typename Floating,
+            std::enable_if_t<std::is_floating_point<Floating>::value, bool> = true>
+    size_t hash(Floating &key) {
+        size_t result = 0;
+        memcpy(&result, &key, sizeof(Floating));
+        return result & 0xfffff000;
+    };
+    size_t hash(const char* key) {
+        unsigned h = 0;
+        while (*key) {
+            h = h * 101 + (unsigned) *key++;
+        }
+        return h;
+    };
+    size_t hash(const std::string key) {
+        unsigned h = 0;
+        const char *a = key.c_str();
+        while (*a) {
+            h = h * 101 + (unsigned) *a++;
+        }
+        return h;
+    };
+};
\ No newline at end of file
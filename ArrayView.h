@@ -0,0 +1,41 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include "Exceptions.h"
+
+// non-owning view of size elements starting at data (std::span is C++20), the array has to outlive the view,
+// sets fill views given by the caller and give out views of their own storage instead of new[]'d copies
+template<class type> class ArrayView {
+    type *data;
+    size_t size;
+public:
+    ArrayView() : data(nullptr), size(0) {};
+    ArrayView(type *data, size_t size) : data(data), size(size) {};
+    template<size_t N>
+    ArrayView(type (&array)[N]) : data(array), size(N) {};
+    ArrayView(std::vector<type> &vector) : data(vector.data()), size(vector.size()) {};
+
+    // unchecked, like operator[] of arrays
+    type &operator[](size_t i) {return data[i];};
+    type &at(size_t i) {
+        if (i >= size) {
+            throw IndexOutOfRangeException();
+        }
+        return data[i];
+    };
+    // count elements from offset
+    ArrayView<type> subView(size_t offset, size_t count) {
+        if (offset > size || count > size - offset) {
+            throw IndexOutOfRangeException();
+        }
+        return ArrayView<type>(data + offset, count);
+    };
+
+    type *getData() {return data;};
+    size_t getSize() {return size;};
+    bool isEmpty() {return size == 0;};
+
+    type *begin() {return data;};
+    type *end() {return data + size;};
+};
\ No newline at end of file
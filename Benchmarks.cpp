@@ -0,0 +1,643 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <malloc.h>
+
+#include "OrderedSet.h"
+#include "FlatOrderedSet.h"
+#include "ConcurrentOrderedSet.h"
+#include "IntegerOrderedSet.h"
+#include "AdaptiveOrderedSet.h"
+#include "CombinedSet.h"
+#include "UniqueCombinedSet.h"
+#include "UniqueSet.h"
+#include "IntrusiveUniqueSet.h"
+#include "SlotMap.h"
+#include "PartitionedCombinedSet.h"
+
+template<typename Function>
+double measure(const std::string &name, size_t operations, Function f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << time.count() / operations << " ns/op" << std::endl;
+    return time.count();
+}
+
+std::vector<unsigned> randomKeys(size_t n, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::vector<unsigned> keys(n);
+    for (auto &key : keys) {
+        key = generator();
+    }
+    return keys;
+}
+
+void flatOrderedSetBenchmark(size_t n, size_t lookups) {
+    std::cout << "--- OrderedSet vs FlatOrderedSet, " << n << " elements" << std::endl;
+    auto keys = randomKeys(n, 1), probes = randomKeys(lookups, 2);
+    for (size_t i = 0; i < lookups; i += 2) {
+        probes[i] = keys[probes[i] % n]; // half hits
+    }
+    OrderedSet<unsigned> tree;
+    for (auto key : keys) {
+        tree.add(key);
+    }
+    FlatOrderedSet<unsigned> flat(tree);
+    n = tree.getSize(); // random keys can repeat
+    size_t found = 0;
+    double treeTime = measure("OrderedSet::contains", lookups, [&] {
+        for (auto probe : probes) found += tree.contains(probe);
+    });
+    double flatTime = measure("FlatOrderedSet::contains", lookups, [&] {
+        for (auto probe : probes) found += flat.contains(probe);
+    });
+    std::cout << "speedup: " << treeTime / flatTime << "x" << std::endl;
+    treeTime = measure("OrderedSet::getItem", lookups, [&] {
+        for (auto probe : probes) found += tree.getItem(probe % n);
+    });
+    flatTime = measure("FlatOrderedSet::getItem", lookups, [&] {
+        for (auto probe : probes) found += flat.getItem(probe % n);
+    });
+    std::cout << "speedup: " << treeTime / flatTime << "x" << std::endl;
+    std::cout << "bytes per element: FlatOrderedSet " << sizeof(size_t) + sizeof(unsigned) << std::endl;
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+// every thread does 50% contains, 25% add, 25% remove on shared keys
+template<typename Operation>
+void runThreads(const std::string &name, unsigned threads, size_t operationsPerThread, Operation operation) {
+    std::vector<std::thread> workers;
+    measure(name + ", " + std::to_string(threads) + " threads", threads * operationsPerThread, [&] {
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                auto keys = randomKeys(operationsPerThread, t + 10);
+                for (size_t i = 0; i < operationsPerThread; i++) {
+                    operation(i % 4, keys[i] % (1 << 16));
+                }
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    });
+}
+
+void concurrentOrderedSetBenchmark(size_t operationsPerThread) {
+    std::cout << "--- ConcurrentOrderedSet vs OrderedSet with a mutex, " << operationsPerThread << " ops per thread" << std::endl;
+    for (unsigned threads = 1; threads <= 8; threads *= 2) {
+        ConcurrentOrderedSet<int> concurrent;
+        runThreads("ConcurrentOrderedSet", threads, operationsPerThread, [&](size_t operation, int key) {
+            if (operation < 2) {
+                concurrent.contains(key);
+            } else if (operation == 2) {
+                concurrent.add(key);
+            } else {
+                concurrent.tryRemove(key);
+            }
+        });
+        OrderedSet<int> ordered;
+        std::mutex mutex;
+        runThreads("OrderedSet + mutex", threads, operationsPerThread, [&](size_t operation, int key) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (operation < 2) {
+                ordered.contains(key);
+            } else if (operation == 2) {
+                ordered.add(key);
+            } else if (ordered.contains(key)) {
+                ordered.remove(key);
+            }
+        });
+    }
+}
+
+// heap bytes in use, counts allocator headers and padding too
+size_t heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd; // big chunks are mmapped
+}
+
+void nodePoolBenchmark(size_t n) {
+    std::cout << "--- OrderedSet nodes, " << n << " elements" << std::endl;
+    auto keys = randomKeys(n, 3);
+    size_t found = 0, before = heapInUse();
+    OrderedSet<unsigned> tree;
+    measure("OrderedSet::add", n, [&] {
+        for (auto key : keys) tree.add(key);
+    });
+    std::cout << "bytes per element: " << double(heapInUse() - before) / tree.getSize() << std::endl;
+    measure("OrderedSet::contains", n, [&] {
+        for (auto key : keys) found += tree.contains(key);
+    });
+    measure("OrderedSet::getSortedList", tree.getSize(), [&] {
+        unsigned *list = tree.getSortedList();
+        found += list[0];
+        delete[] list;
+    });
+    std::atomic<size_t> sum(0);
+    measure("OrderedSet::forEach, " + std::to_string(std::thread::hardware_concurrency()) + " threads", tree.getSize(), [&] {
+        tree.forEach([&](unsigned key) {sum.fetch_add(key & 1, std::memory_order_relaxed);});
+    });
+    found += sum;
+    measure("OrderedSet::clear", tree.getSize(), [&] {
+        tree.clear();
+    });
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+void integerOrderedSetBenchmark(size_t n, size_t lookups) {
+    std::cout << "--- OrderedSet vs IntegerOrderedSet, " << n << " elements" << std::endl;
+    auto keys = randomKeys(n, 4), probes = randomKeys(lookups, 5);
+    for (size_t i = 0; i < lookups; i += 2) {
+        probes[i] = keys[probes[i] % n];
+    }
+    size_t found = 0, before = heapInUse();
+    OrderedSet<unsigned> tree;
+    double treeTime = measure("OrderedSet::add", n, [&] {
+        for (auto key : keys) tree.add(key);
+    });
+    size_t treeBytes = heapInUse() - before;
+    before = heapInUse();
+    IntegerOrderedSet<unsigned> integers;
+    double integerTime = measure("IntegerOrderedSet::add", n, [&] {
+        for (auto key : keys) integers.add(key);
+    });
+    std::cout << "speedup: " << treeTime / integerTime << "x, bytes per element: OrderedSet "
+              << double(treeBytes) / n << ", IntegerOrderedSet " << double(heapInUse() - before) / n << std::endl;
+    n = tree.getSize();
+    treeTime = measure("OrderedSet::contains", lookups, [&] {
+        for (auto probe : probes) found += tree.contains(probe);
+    });
+    integerTime = measure("IntegerOrderedSet::contains", lookups, [&] {
+        for (auto probe : probes) found += integers.contains(probe);
+    });
+    std::cout << "speedup: " << treeTime / integerTime << "x" << std::endl;
+    treeTime = measure("OrderedSet::getItem", lookups, [&] {
+        for (auto probe : probes) found += tree.getItem(probe % n);
+    });
+    integerTime = measure("IntegerOrderedSet::getItem", lookups, [&] {
+        for (auto probe : probes) found += integers.getItem(probe % n);
+    });
+    std::cout << "speedup: " << treeTime / integerTime << "x" << std::endl;
+    treeTime = measure("OrderedSet::getIndex", n, [&] {
+        for (auto key : keys) found += tree.getIndex(key);
+    });
+    integerTime = measure("IntegerOrderedSet::getIndex", n, [&] {
+        for (auto key : keys) found += integers.getIndex(key);
+    });
+    std::cout << "speedup: " << treeTime / integerTime << "x" << std::endl;
+    measure("IntegerOrderedSet::successor", lookups, [&] {
+        for (auto probe : probes) found += (probe < integers.max()) ? integers.successor(probe) : 0;
+    });
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+// keys arrive in order except for small local swaps, like timestamps of an event stream
+void nearlySortedBenchmark(size_t n) {
+    std::cout << "--- OrderedSet, nearly sorted stream of " << n << " elements" << std::endl;
+    auto jitter = randomKeys(n, 6);
+    std::vector<unsigned> keys(n);
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = unsigned(i * 4 + jitter[i] % 16);
+    }
+    size_t found = 0;
+    OrderedSet<unsigned> stream;
+    measure("OrderedSet::add", n, [&] {
+        for (auto key : keys) stream.add(key);
+    });
+    measure("OrderedSet::contains", n, [&] {
+        for (auto key : keys) found += stream.contains(key);
+    });
+    std::sort(keys.begin(), keys.end());
+    OrderedSet<unsigned> batch;
+    measure("OrderedSet::addSortedRun", n, [&] {
+        batch.addSortedRun(keys.begin(), keys.end());
+    });
+    for (auto &key : keys) {
+        key += 2; // interleaves with the set
+    }
+    measure("OrderedSet::addSortedRun into " + std::to_string(batch.getSize()), n, [&] {
+        batch.addSortedRun(keys.begin(), keys.end());
+    });
+    std::cout << "(checksum " << found + batch.getSize() << ")" << std::endl;
+}
+
+// interleaved descents against one lookup after another on a tree much bigger than the caches
+void batchLookupBenchmark(size_t n, size_t lookups) {
+    std::cout << "--- OrderedSet batch lookups, " << n << " elements" << std::endl;
+    auto keys = randomKeys(n, 7), probes = randomKeys(lookups, 8);
+    for (size_t i = 0; i < lookups; i += 2) {
+        probes[i] = keys[probes[i] % n];
+    }
+    OrderedSet<unsigned> tree;
+    for (auto key : keys) {
+        tree.add(key);
+    }
+    size_t found = 0;
+    double sequentialTime = measure("OrderedSet::contains", lookups, [&] {
+        for (auto probe : probes) found += tree.contains(probe);
+    });
+    bool *hits = new bool[lookups];
+    double batchTime = measure("OrderedSet::containsBatch", lookups, [&] {
+        tree.containsBatch(probes.data(), lookups, hits);
+    });
+    found += std::count(hits, hits + lookups, true);
+    delete[] hits;
+    std::cout << "speedup: " << sequentialTime / batchTime << "x" << std::endl;
+    std::vector<size_t> indexes(n);
+    sequentialTime = measure("OrderedSet::getIndex", n, [&] {
+        for (auto key : keys) found += tree.getIndex(key);
+    });
+    batchTime = measure("OrderedSet::getIndexBatch", n, [&] {
+        tree.getIndexBatch(keys.data(), n, indexes.data());
+    });
+    found += indexes[n / 2];
+    std::cout << "speedup: " << sequentialTime / batchTime << "x" << std::endl;
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+// thousands of small sets, the common case the arrays of AdaptiveOrderedSet are for
+void smallSetsBenchmark(size_t sets, size_t elements) {
+    std::cout << "--- OrderedSet vs AdaptiveOrderedSet, " << sets << " sets of " << elements << " elements" << std::endl;
+    auto keys = randomKeys(sets * elements, 9);
+    size_t found = 0, before = heapInUse();
+    std::vector<OrderedSet<unsigned>> trees(sets);
+    double treeTime = measure("OrderedSet::add", keys.size(), [&] {
+        for (size_t i = 0; i < keys.size(); i++) trees[i % sets].add(keys[i]);
+    });
+    size_t treeBytes = heapInUse() - before;
+    before = heapInUse();
+    std::vector<AdaptiveOrderedSet<unsigned>> adaptive(sets);
+    double adaptiveTime = measure("AdaptiveOrderedSet::add", keys.size(), [&] {
+        for (size_t i = 0; i < keys.size(); i++) adaptive[i % sets].add(keys[i]);
+    });
+    std::cout << "speedup: " << treeTime / adaptiveTime << "x, bytes per element: OrderedSet "
+              << double(treeBytes) / keys.size() << ", AdaptiveOrderedSet " << double(heapInUse() - before) / keys.size() << std::endl;
+    treeTime = measure("OrderedSet::contains", keys.size(), [&] {
+        for (size_t i = 0; i < keys.size(); i++) found += trees[i % sets].contains(keys[i] ^ (i & 1));
+    });
+    adaptiveTime = measure("AdaptiveOrderedSet::contains", keys.size(), [&] {
+        for (size_t i = 0; i < keys.size(); i++) found += adaptive[i % sets].contains(keys[i] ^ (i & 1));
+    });
+    std::cout << "speedup: " << treeTime / adaptiveTime << "x" << std::endl;
+    treeTime = measure("OrderedSet::getIndex", keys.size(), [&] {
+        for (size_t i = 0; i < keys.size(); i++) found += trees[i % sets].getIndex(keys[i]);
+    });
+    adaptiveTime = measure("AdaptiveOrderedSet::getIndex", keys.size(), [&] {
+        for (size_t i = 0; i < keys.size(); i++) found += adaptive[i % sets].getIndex(keys[i]);
+    });
+    std::cout << "speedup: " << treeTime / adaptiveTime << "x" << std::endl;
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+// pages of a ranked view, one getItem per element against one iterator placed per page
+void paginationBenchmark(size_t n, size_t pages, size_t pageSize) {
+    std::cout << "--- OrderedSet pages of " << pageSize << " out of " << n << " elements" << std::endl;
+    auto keys = randomKeys(n, 10), starts = randomKeys(pages, 11);
+    OrderedSet<unsigned> tree;
+    for (auto key : keys) {
+        tree.add(key);
+    }
+    size_t found = 0, last = tree.getSize() - pageSize;
+    double itemTime = measure("OrderedSet::getItem", pages * pageSize, [&] {
+        for (auto start : starts) {
+            for (size_t i = start % last; i < start % last + pageSize; i++) found += tree.getItem(i);
+        }
+    });
+    double iteratorTime = measure("OrderedSet::getIteratorAt", pages * pageSize, [&] {
+        for (auto start : starts) {
+            auto iter = tree.getIteratorAt(start % last);
+            for (size_t i = 0; i < pageSize; i++, ++iter) found += iter.getData();
+        }
+    });
+    std::cout << "speedup: " << itemTime / iteratorTime << "x" << std::endl;
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+// mixed type dedup, every add, contains and remove used to allocate a probe
+void combinedSetBenchmark(size_t n) {
+    std::cout << "--- CombinedSet, " << n << " mixed values" << std::endl;
+    auto keys = randomKeys(n, 12);
+    size_t found = 0;
+    CombinedSet<unsigned, long, int> set;
+    measure("CombinedSet::add", n, [&] {
+        for (size_t i = 0; i < n; i++) {
+            if (i % 3 == 0) set.add(keys[i]);
+            else if (i % 3 == 1) set.add(long(keys[i] % 100000));
+            else set.add(int(keys[i] >> 8));
+        }
+    });
+    measure("CombinedSet::contains", n, [&] {
+        for (size_t i = 0; i < n; i++) found += set.contains(keys[i]) + set.contains(long(keys[i] % 100000));
+    });
+    size_t elements = set.getSize();
+    measure("CombinedSet::Iterator, getData in try/catch", elements, [&] {
+        for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+            try {
+                found += iter.getData<unsigned>();
+            } catch (WrongTypeException &e) {
+                try {
+                    found += iter.getData<long>();
+                } catch (WrongTypeException &e) {
+                    found += iter.getData<int>();
+                }
+            }
+        }
+    });
+    measure("CombinedSet::Iterator, tryGet", elements, [&] {
+        for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+            if (unsigned *value = iter.tryGet<unsigned>()) found += *value;
+            else if (long *value = iter.tryGet<long>()) found += *value;
+            else found += *iter.tryGet<int>();
+        }
+    });
+    measure("CombinedSet::forEach", elements, [&] {
+        set.forEach([&](auto value) {found += value;});
+    });
+    CombinedSet<int, long, unsigned, long long> sameKeys;
+    for (size_t i = 0; i < n / 4; i++) {
+        sameKeys.addMultiple(int(keys[i]), long(keys[i]), unsigned(keys[i]), (long long) keys[i]);
+    }
+    measure("CombinedSet::contains, 4 types with equal keys", n / 2, [&] {
+        for (size_t i = 0; i < n / 2; i++) found += sameKeys.contains(int(keys[i]));
+    });
+    sameKeys.clear();
+    measure("CombinedSet::remove", n / 3, [&] {
+        for (size_t i = 0; i < n; i += 3) {
+            if (set.contains(keys[i])) set.remove(keys[i]); // random keys can repeat
+        }
+    });
+    std::cout << "(checksum " << found + set.getSize() << ")" << std::endl;
+}
+
+// the same ints in sets accepting one type and ten types, type dispatch should not depend on the number of types
+void typeCountBenchmark(size_t n) {
+    std::cout << "--- CombinedSet and UniqueCombinedSet, 1 vs 10 types, " << n << " ints" << std::endl;
+    auto keys = randomKeys(n, 13);
+    std::vector<int> values(keys.begin(), keys.end());
+    size_t found = 0;
+    CombinedSet<int> one;
+    CombinedSet<char, short, long, float, double, bool, unsigned, unsigned char, char *, int> ten;
+    double oneTime = measure("CombinedSet<int>::add + contains", n, [&] {
+        for (auto value : values) one.add(value);
+        for (auto value : values) found += one.contains(value);
+    });
+    double tenTime = measure("CombinedSet<10 types>::add + contains", n, [&] {
+        for (auto value : values) ten.add(value);
+        for (auto value : values) found += ten.contains(value);
+    });
+    std::cout << "10 types / 1 type: " << tenTime / oneTime << std::endl;
+    UniqueCombinedSet<int> uniqueOne;
+    UniqueCombinedSet<char, short, long, float, double, bool, unsigned, unsigned char, char *, int> uniqueTen;
+    oneTime = measure("UniqueCombinedSet<int>::add + contains", n, [&] {
+        for (auto &value : values) uniqueOne.add(value);
+        for (auto &value : values) found += uniqueOne.contains(value);
+    });
+    tenTime = measure("UniqueCombinedSet<10 types>::add + contains", n, [&] {
+        for (auto &value : values) uniqueTen.add(value);
+        for (auto &value : values) found += uniqueTen.contains(value);
+    });
+    std::cout << "10 types / 1 type: " << tenTime / oneTime << std::endl;
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+// registry of heap objects, addresses 16 byte aligned
+void uniqueSetBenchmark(size_t n) {
+    std::cout << "--- UniqueSet, " << n << " heap objects" << std::endl;
+    std::vector<std::string *> objects(n);
+    for (auto &object : objects) object = new std::string();
+    std::shuffle(objects.begin(), objects.end(), std::mt19937(16));
+    size_t found = 0, before = heapInUse();
+    UniqueSet<std::string> set;
+    measure("UniqueSet::add", n, [&] {
+        for (auto object : objects) set.add(*object);
+    });
+    std::cout << "heap bytes per element: " << double(heapInUse() - before) / n << std::endl;
+    measure("UniqueSet::contains", n, [&] {
+        for (auto object : objects) found += set.contains(*object);
+    });
+    measure("UniqueSet::remove", n, [&] {
+        for (auto object : objects) set.remove(*object);
+    });
+    for (auto object : objects) delete object;
+    std::cout << "(checksum " << found + set.getSize() << ")" << std::endl;
+}
+
+struct Session {
+    size_t id;
+    UniqueSetHook uniqueSetHook;
+};
+
+// registry churn: every round removes a random half of the objects and adds them back
+void intrusiveSetBenchmark(size_t n, size_t rounds) {
+    std::cout << "--- UniqueSet and IntrusiveUniqueSet, " << n << " objects, " << rounds << " rounds of churn" << std::endl;
+    std::vector<Session *> sessions(n);
+    for (size_t i = 0; i < n; i++) sessions[i] = new Session{i, {}};
+    std::mt19937 generator(17);
+    std::vector<Session *> churn(sessions.begin(), sessions.end());
+    size_t found = 0;
+    UniqueSet<Session> plain;
+    IntrusiveUniqueSet<Session> intrusive;
+    for (auto session : sessions) {
+        plain.add(*session);
+        intrusive.add(*session);
+    }
+    std::shuffle(churn.begin(), churn.end(), generator);
+    churn.resize(n / 2);
+    measure("UniqueSet::remove + add", rounds * n, [&] {
+        for (size_t r = 0; r < rounds; r++) {
+            for (auto session : churn) plain.remove(*session);
+            for (auto session : churn) plain.add(*session);
+        }
+    });
+    measure("IntrusiveUniqueSet::remove + add", rounds * n, [&] {
+        for (size_t r = 0; r < rounds; r++) {
+            for (auto session : churn) intrusive.remove(*session);
+            for (auto session : churn) intrusive.add(*session);
+        }
+    });
+    measure("UniqueSet::contains", n, [&] {
+        for (auto session : sessions) found += plain.contains(*session);
+    });
+    measure("IntrusiveUniqueSet::contains", n, [&] {
+        for (auto session : sessions) found += intrusive.contains(*session);
+    });
+    intrusive.clear();
+    for (auto session : sessions) delete session;
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+struct Entity {
+    float x, y, dx, dy;
+};
+
+// per frame pass over every entity, allocated one by one for UniqueSet, owned by the SlotMap
+void slotMapBenchmark(size_t n, size_t frames) {
+    std::cout << "--- UniqueSet and SlotMap, " << n << " entities, " << frames << " frames" << std::endl;
+    std::vector<Entity *> entities(n);
+    for (auto &entity : entities) entity = new Entity{1, 2, 0.5f, 0.25f};
+    std::shuffle(entities.begin(), entities.end(), std::mt19937(18));
+    UniqueSet<Entity> set;
+    SlotMap<Entity> map;
+    std::vector<SlotMap<Entity>::Handle> handles;
+    measure("UniqueSet::add", n, [&] {
+        for (auto entity : entities) set.add(*entity);
+    });
+    measure("SlotMap::add", n, [&] {
+        for (auto entity : entities) handles.push_back(map.add(*entity));
+    });
+    float checksum = 0;
+    measure("UniqueSet::Iterator, read every entity", frames * n, [&] {
+        for (size_t f = 0; f < frames; f++) {
+            for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+                Entity entity = iter.getData();
+                checksum += entity.x * entity.dx + entity.y * entity.dy;
+            }
+        }
+    });
+    measure("SlotMap::forEach, read every entity", frames * n, [&] {
+        for (size_t f = 0; f < frames; f++) {
+            map.forEach([&](Entity &entity) {checksum += entity.x * entity.dx + entity.y * entity.dy;});
+        }
+    });
+    checksum += map.get(handles[0]).x;
+    measure("SlotMap::remove", n, [&] {
+        for (auto handle : handles) map.remove(handle);
+    });
+    for (auto entity : entities) delete entity;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+}
+
+// getList / getSortedList allocate and copy every element, fill reuses the caller's buffer, getSlots copies nothing
+void exportBenchmark(size_t n) {
+    std::cout << "--- exporting " << n << " elements" << std::endl;
+    std::vector<std::string> objects(n, "some object with a long name");
+    UniqueSet<std::string> set;
+    for (auto &object : objects) set.add(object);
+    size_t found = 0;
+    measure("UniqueSet::getList", n, [&] {
+        std::string *list = set.getList();
+        found += list[0].size();
+        delete[] list;
+    });
+    std::vector<std::string *> pointers(n);
+    measure("UniqueSet::fill, pointers", n, [&] {
+        found += set.fill(pointers);
+    });
+    measure("UniqueSet::getSlots, scan", n, [&] {
+        for (std::string *slot : set.getSlots()) found += slot != nullptr;
+    });
+    OrderedSet<int> ordered;
+    auto keys = randomKeys(n, 19);
+    std::sort(keys.begin(), keys.end());
+    ordered.addSortedRun(keys.begin(), std::unique(keys.begin(), keys.end()));
+    measure("OrderedSet::getSortedList", ordered.getSize(), [&] {
+        int *list = ordered.getSortedList();
+        found += list[0];
+        delete[] list;
+    });
+    std::vector<int> buffer(ordered.getSize());
+    ordered.fill(buffer);
+    measure("OrderedSet::fill, reused buffer", ordered.getSize(), [&] {
+        found += ordered.fill(buffer);
+    });
+    ordered.clear();
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+void uniqueCombinedSetBenchmark(size_t n) {
+    std::cout << "--- UniqueCombinedSet, " << n << " objects of 2 types" << std::endl;
+    std::vector<int> ints(n / 2);
+    std::vector<std::string> strings(n / 2);
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; i++) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(15));
+    size_t found = 0, before = heapInUse();
+    UniqueCombinedSet<int, std::string> set;
+    measure("UniqueCombinedSet::add", n, [&] {
+        for (size_t i : order) (i % 2 == 0) ? set.add(ints[i / 2]) : set.add(strings[i / 2]);
+    });
+    std::cout << "heap bytes per element: " << double(heapInUse() - before) / n << std::endl;
+    measure("UniqueCombinedSet::contains", n, [&] {
+        for (size_t i : order) found += (i % 2 == 0) ? set.contains(ints[i / 2]) : set.contains(strings[i / 2]);
+    });
+    measure("UniqueCombinedSet::remove", n, [&] {
+        for (size_t i : order) (i % 2 == 0) ? set.remove(ints[i / 2]) : set.remove(strings[i / 2]);
+    });
+    std::cout << "(checksum " << found + set.getSize() << ")" << std::endl;
+}
+
+// one type out of several: CombinedSet filters every element, PartitionedCombinedSet reads only that type's array
+void partitionedSetBenchmark(size_t n) {
+    std::cout << "--- PartitionedCombinedSet, " << n << " values of 3 types, scanning one" << std::endl;
+    auto keys = randomKeys(n, 14);
+    size_t found = 0;
+    CombinedSet<unsigned, long, int> combined;
+    PartitionedCombinedSet<unsigned, long, int> partitioned, other;
+    measure("CombinedSet::add", n, [&] {
+        for (size_t i = 0; i < n; i++) {
+            if (i % 3 == 0) combined.add(keys[i]);
+            else if (i % 3 == 1) combined.add(long(keys[i]));
+            else combined.add(int(keys[i]));
+        }
+    });
+    measure("PartitionedCombinedSet::add", n, [&] {
+        for (size_t i = 0; i < n; i++) {
+            if (i % 3 == 0) partitioned.add(keys[i]);
+            else if (i % 3 == 1) partitioned.add(long(keys[i]));
+            else partitioned.add(int(keys[i]));
+        }
+    });
+    measure("CombinedSet::contains", n, [&] {
+        for (size_t i = 0; i < n; i++) found += combined.contains(keys[i]);
+    });
+    measure("PartitionedCombinedSet::contains", n, [&] {
+        for (size_t i = 0; i < n; i++) found += partitioned.contains(keys[i]);
+    });
+    size_t longs = partitioned.getSize<long>();
+    measure("CombinedSet::Iterator, tryGet<long>", longs, [&] {
+        for (auto iter = combined.getIterator(); iter.finished(); ++iter) {
+            if (long *value = iter.tryGet<long>()) found += *value;
+        }
+    });
+    measure("PartitionedCombinedSet::forEach<long>", longs, [&] {
+        partitioned.forEach<long>([&](long value) {found += value;});
+    });
+    for (size_t i = 0; i < n; i += 2) {
+        other.add(keys[i]);
+        other.add(long(keys[i]));
+        other.add(int(keys[i]));
+    }
+    measure("PartitionedCombinedSet::setIntersection", n, [&] {
+        found += partitioned.setIntersection(other).getSize();
+    });
+    measure("PartitionedCombinedSet::setUnion", n, [&] {
+        found += partitioned.setUnion(other).getSize();
+    });
+    combined.clear();
+    std::cout << "(checksum " << found << ")" << std::endl;
+}
+
+int main() {
+    nodePoolBenchmark(1 << 20);
+    nearlySortedBenchmark(1 << 20);
+    batchLookupBenchmark(1 << 20, 1 << 22);
+    smallSetsBenchmark(1 << 14, 48);
+    paginationBenchmark(1 << 20, 1 << 14, 50);
+    combinedSetBenchmark(1 << 20);
+    typeCountBenchmark(1 << 18);
+    uniqueSetBenchmark(1 << 20);
+    intrusiveSetBenchmark(1 << 18, 8);
+    slotMapBenchmark(1 << 18, 16);
+    exportBenchmark(1 << 22);
+    uniqueCombinedSetBenchmark(1 << 20);
+    partitionedSetBenchmark(1 << 20);
+    integerOrderedSetBenchmark(1 << 20, 1 << 22);
+    flatOrderedSetBenchmark(1 << 20, 1 << 22);
+    concurrentOrderedSetBenchmark(1 << 18);
+    return 0;
+}
\ No newline at end of file
@@ -5,8 +5,7 @@
 #include <cmath>
 #include <stdexcept>
 #include <type_traits>
-#include <tuple>
-#include <cassert>
+#include <variant>
 #include "Exceptions.h"
 
 
@@ -14,200 +13,109 @@ template<class... types> class CombinedSet {
     const float RESIZE_AT = 0.75;
     const int MULTIPLY_SIZE_BY = 2;
 
-    class Type {
-        size_t index;
-    public:
-        Type(size_t i) : index(i) {};
-        size_t getTypeId() {return index;};
-    };
+    using Data = std::variant<types...>;
+    static constexpr size_t typeArraySize = sizeof...(types);
 
-    template<typename T> class Node {
-        T data;
+    // one allocation per element, the value is stored inline together with its type (index of the variant),
+    // key, link and a copy of the type index come first, so walking a chain never reads the values
+    class Entry {
         size_t key;
+        Entry *next = nullptr;
+        unsigned char tag;
+        Data data;
     public:
-        Node(T data, size_t key) : data(data), key(key) {};
-        bool operator==(Node &node) {return key == node.key;};
-        T getData() {return data;};
-        size_t getKey() {return key;};
-    };
-
-    class Wrap {
-        void *node = nullptr;
-        Type *type = nullptr;
-        Wrap *next = nullptr;
-    public:
-        Wrap(void* n, Type *t) : node(n), type(t) {};
-        ~Wrap() {
-            const size_t i = type->getTypeId();
-            deleteThem<typeArraySize>(i);
-        }
-
-        bool operator==(Wrap &other) {
-            if (type->getTypeId() != other.getType()->getTypeId()) {
-                return false;
-            }
-            const size_t i = type->getTypeId();
-            return equal<typeArraySize>(i, other);
-        }
-        void *getNode() {return node;};
-        Type *getType() {return type;};
-        Wrap *getNext() {return next;};
-        template<typename T>
-        T getData() {
-            if (!checkType<T, typeArraySize>(type->getTypeId())) {
-                throw WrongTypeException();
-            }
-            Node<T> *n = static_cast<Node<T>*>(node);
-            return n->getData();
-        }
-        size_t getKey() {return getNodeKey<typeArraySize>(type->getTypeId());};
-
-        void setNext(Wrap *n) {(next == nullptr) ? next=n : throw OccupiedSpaceException();};
-
-
-    private:
-        template<size_t I, std::enable_if_t<0<I, bool> = true>
-        size_t getNodeKey(size_t i) {
-            if (I > typeArraySize || I-1 < i) {
-                throw TypeNotAcceptedException();
-            }
-            if (I-1 > i) {
-                return getNodeKey<I-1>(i);;
-            }
-            using t = typename std::tuple_element<I-1, typeArray>::type;
-            Node<t> *n = static_cast<Node<t>*>(node);
-            return n->getKey();
-        }
-
-        template<size_t I, std::enable_if_t<0==I, bool> = true>
-        size_t getNodeKey(size_t i) {return -1;} // <- this function should never fire, only required for compilation
-
-        template<typename type, size_t I, std::enable_if_t<0<I, bool> = true>
-        bool checkType(size_t i) {
-            if (I > typeArraySize || I-1 < i) {
-                throw TypeNotAcceptedException();
-            }
-            if (I-1 > i) {
-                return checkType<type, I-1>(i);
-            }
-            using t = typename std::tuple_element<I-1, typeArray>::type;
-            return typeid(type) == typeid(t);
-        }
+        Entry(const Data &data, size_t key) : key(key), tag(data.index()), data(data) {};
+        template<size_t I, typename T>
+        Entry(std::in_place_index_t<I> typeId, T &value, size_t key) : key(key), tag(I), data(typeId, value) {};
 
-        template<typename type, size_t I, std::enable_if_t<0==I, bool> = true>
-        bool checkType(size_t i) {return false;}
-
-        template<size_t I, std::enable_if_t<0<I, bool> = true>
-        void deleteThem(size_t i) {
-            if (I > typeArraySize || I-1 < i) {
-                throw TypeNotAcceptedException();
-            }
-            if (I-1 > i) {
-                deleteThem<I-1>(i);
-                return;
-            }
-            using t = typename std::tuple_element<I-1, typeArray>::type;
-            Node<t> *n = static_cast<Node<t>*>(node);
-            delete n;
-            delete type;
-        }
-
-        template<size_t I, std::enable_if_t<0==I, bool> = true>
-        void deleteThem(size_t i) {}
-
-        template<size_t I, std::enable_if_t<0<I, bool> = true>
-        bool equal(size_t i, Wrap &other) {
-            if (I > typeArraySize || I-1 < i) {
-                throw TypeNotAcceptedException();
-            }
-            if (I-1 > i) {
-                return equal<I-1>(i, other);
-            }
-            using t = typename std::tuple_element<I-1, typeArray>::type;
-            Node<t> *n1 = static_cast<Node<t>*>(node), *n2 = static_cast<Node<t>*>(other.getNode());
-            return *n1 == *n2;
-        }
-
-        template<size_t I, std::enable_if_t<0==I, bool> = true>
-        bool equal(size_t i, Wrap &other) {
-            return false;
-        }
+        bool matches(size_t typeId, size_t k) {return tag == typeId && key == k;};
+        Data &getData() {return data;};
+        size_t getKey() {return key;};
+        size_t getTypeId() {return tag;};
+        Entry *getNext() {return next;};
+        void setNext(Entry *n) {next = n;};
     };
 
-    using typeArray = std::tuple<types...>;
-    static constexpr size_t typeArraySize = sizeof...(types);
     size_t capacity = 0;
     size_t size = 0;
-    Wrap **list;
+    Entry **list;
 public:
     explicit CombinedSet(size_t startingCapacity = 10) {
-        list = new Wrap*[startingCapacity] {nullptr};
+        list = new Entry*[startingCapacity] {nullptr};
         capacity = startingCapacity;
     };
 
     class Iterator {
         friend CombinedSet<types...>;
 
-        Wrap *wrapper;
-        size_t i;
         CombinedSet<types...> set;
-        Wrap *last;
-        bool end = false;
+        size_t i;
+        Entry *entry;
     public:
-        explicit Iterator(CombinedSet<types...> set) : wrapper(nullptr), i(0), set(set) {
-            Wrap* w = nullptr;
-            for (int j = 0; j < set.capacity; j++) {
-                if (set.list[j] != nullptr) {
-                    w = set.list[j];
-                    if (wrapper == nullptr) {
-                        i = j;
-                        wrapper = set.list[j];
-                    }
-                }
-            }
-            if (w != nullptr) {
-                while (w->getNext() != nullptr) {
-                    w = w->getNext();
-                }
-            } else {
-                end = true;
-            }
-            last = w;
+        explicit Iterator(CombinedSet<types...> set) : set(set), i(0), entry(nullptr) {
+            skipEmpty();
         }
 
         void operator++() {
-            if (i >= (int) set.capacity || i < 0) {
+            if (entry == nullptr) {
                 throw IndexOutOfRangeException();
             }
-            if (wrapper == nullptr) {
+            entry = entry->getNext();
+            if (entry == nullptr) {
                 i++;
-                if (i >= set.capacity) {
-                    return;
-                }
-                wrapper = set.list[i];
-            } else {
-                wrapper = wrapper->getNext();
-            }
-            if (wrapper == nullptr) {
-                ++(*this);
+                skipEmpty();
             }
         };
 
         template<typename type>
-        type getData() {return (wrapper != nullptr) ? wrapper->template getData<type>() : throw EmptySetException();}
+        type getData() {
+            if (entry == nullptr) {
+                throw EmptySetException();
+            }
+            constexpr size_t typeId = indexOf<type>();
+            if constexpr (typeId == typeArraySize) {
+                throw WrongTypeException();
+            } else {
+                if (entry->getTypeId() != typeId) {
+                    throw WrongTypeException();
+                }
+                return std::get<typeId>(entry->getData());
+            }
+        }
 
-        bool finished() {
-            if (end) {
-                return false;
+        // nullptr instead of exceptions when the element has another type or there is no element
+        template<typename type>
+        type *tryGet() {
+            constexpr size_t typeId = indexOf<type>();
+            if constexpr (typeId == typeArraySize) {
+                return nullptr;
+            } else {
+                return (entry == nullptr) ? nullptr : std::get_if<typeId>(&entry->getData());
             }
-            if (wrapper == last) {
-                end = true;
+        }
+
+        // calls f with the element as its own type, f has to accept all types of the set (overloads or auto)
+        template<typename Function>
+        void visit(Function &&f) {
+            if (entry == nullptr) {
+                throw EmptySetException();
             }
-            return true;
-        };
+            std::visit(f, entry->getData());
+        }
+
+        bool finished() {return entry != nullptr;};
 
     private:
-        Wrap* getWrapper() {return wrapper;}
+        Entry *getEntry() {return entry;}
+
+        void skipEmpty() {
+            for (; i < set.capacity; i++) {
+                if (set.list[i] != nullptr) {
+                    entry = set.list[i];
+                    return;
+                }
+            }
+        };
     };
 
     friend Iterator;
@@ -215,10 +123,23 @@ public:
         return Iterator(*this);
     }
 
+    // calls f for every element with its own type, like Iterator::visit
+    template<typename Function>
+    void forEach(Function &&f) {
+        for (size_t i = 0; i < capacity; i++) {
+            for (Entry *entry = list[i]; entry != nullptr; entry = entry->getNext()) {
+                std::visit(f, entry->getData());
+            }
+        }
+    };
+
     CombinedSet<types...> setUnion(CombinedSet<types...> otherSet) {
-        CombinedSet<types...> newSet {otherSet};
+        CombinedSet<types...> newSet(otherSet.capacity);
+        for (auto iter = otherSet.getIterator(); iter.finished(); ++iter) {
+            newSet.addEntry(iter.getEntry());
+        }
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            newSet.CopyNodeValueAndAddIt<newSet.typeArraySize>(iter.getWrapper()->getType()->getTypeId(), iter.getWrapper()->getNode());
+            newSet.addEntry(iter.getEntry());
         }
         return newSet;
     };
@@ -226,8 +147,8 @@ public:
     CombinedSet<types...> setIntersection(CombinedSet<types...> otherSet) {
         CombinedSet<types...> newSet;
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            if (otherSet.containsWrapper(iter.getWrapper())) {
-                newSet.CopyNodeValueAndAddIt<newSet.typeArraySize>(iter.getWrapper()->getType()->getTypeId(), iter.getWrapper()->getNode());
+            if (otherSet.containsEntry(iter.getEntry())) {
+                newSet.addEntry(iter.getEntry());
             }
         }
         return newSet;
@@ -238,7 +159,7 @@ public:
             return false;
         }
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            if (!otherSet.containsWrapper(iter.getWrapper())) {
+            if (!otherSet.containsEntry(iter.getEntry())) {
                 return false;
             }
         }
@@ -246,7 +167,7 @@ public:
     };
     bool operator<(CombinedSet<types...> otherSet) {
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            if (!otherSet.containsWrapper(iter.getWrapper())) {
+            if (!otherSet.containsEntry(iter.getEntry())) {
                 return false;
             }
         }
@@ -260,13 +181,13 @@ public:
     bool operator>=(CombinedSet<types...> otherSet) {return *this > otherSet || *this == otherSet;};
 
     void clear() {
-        Wrap *w = nullptr;
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            delete w;
-            w = iter.getWrapper();
-        }
-        delete w;
-        for (int i = 0; i < capacity; i++) {
+        for (size_t i = 0; i < capacity; i++) {
+            Entry *entry = list[i];
+            while (entry != nullptr) {
+                Entry *next = entry->getNext();
+                delete entry;
+                entry = next;
+            }
             list[i] = nullptr;
         }
         size = 0;
@@ -278,54 +199,43 @@ public:
     void add(type value) { add<type>(value, hash(value)); };
     template<typename type>
     void add(type value, int key) {
-        Type *newType = new Type(getTypeId<type>());
-        Node<type> *newNode = new Node<type>(value, key);
-        Wrap *wrapper = new Wrap(newNode, newType);
-        addToList(wrapper, key%capacity);
+        constexpr size_t typeId = indexOf<type>();
+        if constexpr (typeId == typeArraySize) {
+            throw TypeNotAcceptedException();
+        } else if (find(typeId, key) == nullptr) {
+            addToList(new Entry(std::in_place_index<typeId>, value, key));
+        }
     };
 
     template<typename type>
     void remove(type value) { remove(value, hash(value)); };
     template<typename type>
     void remove(type value, int key) {
-        Type *t = new Type(getTypeId<type>());
-        Node<type> *n = new Node<type>(value, key);
-        Wrap *wrapper = list[key%capacity], *w = nullptr, *wrapperToRemove = new Wrap(n, t);
-        while (wrapper != nullptr) {
-            if (*wrapper == *wrapperToRemove) {
-                if (w == nullptr) {
-                    list[key%capacity] = nullptr;
+        size_t typeId = getTypeId<type>(), position = bucketOf(typeId, key);
+        Entry *entry = list[position], *previous = nullptr;
+        while (entry != nullptr) {
+            if (entry->matches(typeId, key)) {
+                if (previous == nullptr) {
+                    list[position] = entry->getNext();
                 } else {
-                    w->setNext(wrapper->getNext());
+                    previous->setNext(entry->getNext());
                 }
-                delete wrapper;
-                delete wrapperToRemove;
+                delete entry;
                 size--;
                 return;
             }
-            w = wrapper;
-            wrapper = wrapper->getNext();
+            previous = entry;
+            entry = entry->getNext();
         }
-        delete wrapperToRemove;
         throw ValueNotFoundException();
     }
 
+    // probes only compare type and key, nothing is allocated
     template<typename type>
     bool contains(type value) { return contains(value, hash(value)); };
     template<typename type>
     bool contains(type value, int key) {
-        Type *t = new Type(getTypeId<type>());
-        Node<type> *n = new Node<type>(value, key);
-        Wrap *wrapper = list[key%capacity], *wrapperToFind = new Wrap(n, t);
-        while (wrapper != nullptr) {
-            if (*wrapper == *wrapperToFind) {
-                delete wrapperToFind;
-                return true;
-            }
-            wrapper = wrapper->getNext();
-        }
-        delete wrapper;
-        return false;
+        return find(getTypeId<type>(), key) != nullptr;
     };
 
     size_t getSize() {return size;}
@@ -343,7 +253,7 @@ private:
     size_t hash(Floating &key) {
         size_t result = 0;
         memcpy(&result, &key, sizeof( double ));
-        return result & 0xfffff000;
+        return result ^ (result >> 32); // keys are ints, so the exponent has to reach the low half
     };
     size_t hash(const char* key) {
         unsigned h = 0;
@@ -361,96 +271,73 @@ private:
         return h;
     };
 
-    template<typename typeToFind, size_t I = 0, std::enable_if_t<I < typeArraySize, bool> = true>
-    size_t getTypeId() {
-        using t = typename std::tuple_element<I, typeArray>::type;
-        if (typeid(typeToFind) == typeid(t)) {
-            return I;
+    // position of type in types, typeArraySize if the set does not accept it
+    template<typename typeToFind>
+    static constexpr size_t indexOf() {
+        constexpr bool matches[] = {std::is_same<typeToFind, types>::value...};
+        for (size_t i = 0; i < typeArraySize; i++) {
+            if (matches[i]) {
+                return i;
+            }
         }
-        return getTypeId<typeToFind, I+1>();
+        return typeArraySize;
     };
 
-    template<typename typeToFind, size_t I = 0, std::enable_if_t<typeArraySize <= I, bool> = true>
+    template<typename typeToFind>
     size_t getTypeId() {
-        throw TypeNotAcceptedException();
+        if constexpr (indexOf<typeToFind>() == typeArraySize) {
+            throw TypeNotAcceptedException();
+        }
+        return indexOf<typeToFind>();
     };
 
-    void addToList(Wrap *wrapperToAdd, const size_t &position) {
-        Wrap *wrapper = list[position];
-        if (wrapper == nullptr) {
-            list[position] = wrapperToAdd;
-            size++;
-            return;
-        }
-        if (*wrapper == *wrapperToAdd) {
-            delete wrapperToAdd;
-            return;
-        }
-        while (wrapper->getNext() != nullptr) {
-            wrapper = wrapper->getNext();
-            if (*wrapper == *wrapperToAdd) {
-                delete wrapperToAdd;
-                return;
-            }
+    // equal keys of different types start in different buckets, types are offset by a multiple of the golden ratio
+    size_t bucketOf(size_t typeId, size_t key) {return (key + typeId * 0x9E3779B97F4A7C15ull) % capacity;};
+
+    Entry *find(size_t typeId, size_t key) {
+        Entry *entry = list[bucketOf(typeId, key)];
+        while (entry != nullptr && !entry->matches(typeId, key)) {
+            entry = entry->getNext();
         }
-        wrapper->setNext(wrapperToAdd);
+        return entry;
+    };
+
+    void addToList(Entry *entryToAdd) {
+        size_t position = bucketOf(entryToAdd->getTypeId(), entryToAdd->getKey());
+        entryToAdd->setNext(list[position]);
+        list[position] = entryToAdd;
         size++;
-        if (size/capacity >= RESIZE_AT) {
+        if (size > capacity * RESIZE_AT) {
             resize(capacity*MULTIPLY_SIZE_BY);
         }
     };
 
-    void resize(const int &newCapacity) {
-        Wrap **oldList = list;
-        list = new Wrap* [newCapacity] {nullptr};
-        size_t oldCapacity = capacity;
-        capacity = newCapacity;
-        size = 0;
-        Wrap *wrapper = nullptr, *w = nullptr;
-        for (int i = 0; i < oldCapacity; i++) {
-            wrapper = oldList[i];
-            while (wrapper != nullptr) {
-//                wrapper->template getINode<typeArraySize, resizeFunctor>(wrapper->getType()->getTypeId()); -> add<t>(node->getData(), node->getKey());
-                CopyNodeValueAndAddIt<typeArraySize>(wrapper->getType()->getTypeId(), wrapper->getNode());
-                w = wrapper;
-                wrapper = wrapper->getNext();
-                delete w;
-            }
+    void addEntry(Entry *entry) {
+        if (find(entry->getTypeId(), entry->getKey()) == nullptr) {
+            addToList(new Entry(entry->getData(), entry->getKey()));
         }
     };
 
-    bool containsWrapper(Wrap *wrapperToFind) {
-        Wrap *wrapper = list[wrapperToFind->getKey()%capacity];
-        while (wrapper != nullptr) {
-            if (*wrapper == *wrapperToFind) {
-                return true;
+    // entries are relinked into the new buckets, not copied
+    void resize(const size_t &newCapacity) {
+        Entry **oldList = list;
+        size_t oldCapacity = capacity;
+        list = new Entry* [newCapacity] {nullptr};
+        capacity = newCapacity;
+        for (size_t i = 0; i < oldCapacity; i++) {
+            Entry *entry = oldList[i];
+            while (entry != nullptr) {
+                Entry *next = entry->getNext();
+                size_t position = bucketOf(entry->getTypeId(), entry->getKey());
+                entry->setNext(list[position]);
+                list[position] = entry;
+                entry = next;
             }
-            wrapper = wrapper->getNext();
         }
-        return false;
-    }
-
-    template<size_t I, std::enable_if_t<0<I, bool> = true>
-    void CopyNodeValueAndAddIt(size_t i, void *node) {
-        if (I > typeArraySize || I-1 < i) {
-            throw TypeNotAcceptedException();
-        }
-        if (I-1 > i) {
-            return CopyNodeValueAndAddIt<I-1>(i, node);
-        }
-        using t = typename std::tuple_element<I-1, typeArray>::type;
-        Node<t> *n = static_cast<Node<t>*>(node);
-        add<t>(n->getData(), n->getKey());
+        delete[] oldList;
     };
 
-    template<size_t I, std::enable_if_t<0==I, bool> = true>
-    void CopyNodeValueAndAddIt(size_t i, void *node) {};
-
-//    template<typename T>
-//    class resizeFunctor {
-//        bool operator()(Node<T> *node) {
-//            add<T>(node->getData(), node->getKey());
-//            return true;
-//        }
-//    };
+    bool containsEntry(Entry *entryToFind) {
+        return find(entryToFind->getTypeId(), entryToFind->getKey()) != nullptr;
+    }
 };
\ No newline at end of file
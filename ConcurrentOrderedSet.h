@@ -0,0 +1,485 @@
+#pragma once
+
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "Exceptions.h"
+
+// epoch based reclamation shared by all concurrent sets, memory of a removed node is freed only after every thread
+// that could have seen it left its critical section
+class EpochReclaimer {
+    static constexpr size_t COLLECT_EVERY = 64;
+
+    struct Retired {
+        void *pointer;
+        void (*destroy)(void *);
+        uint64_t epoch;
+        const void *owner; // structure the pointer was removed from
+    };
+    // one per thread, retired is only locked against release of a structure that is being destroyed
+    struct Record {
+        std::atomic<uint64_t> epoch {0};
+        std::atomic<bool> active {false};
+        std::atomic<bool> used {false};
+        Record *next = nullptr;
+        std::mutex retiredMutex;
+        std::vector<Retired> retired;
+    };
+    struct Local {
+        Record *record = nullptr;
+        size_t depth = 0;
+        ~Local() { // thread exits, someone else has to free what it retired
+            if (record != nullptr) {
+                std::lock_guard<std::mutex> lock(orphanMutex);
+                std::lock_guard<std::mutex> recordLock(record->retiredMutex);
+                orphans.insert(orphans.end(), record->retired.begin(), record->retired.end());
+                record->retired.clear();
+                record->active.store(false);
+                record->used.store(false);
+            }
+        }
+    };
+
+    static inline std::atomic<uint64_t> globalEpoch {0};
+    static inline std::atomic<Record*> records {nullptr};
+    static inline std::mutex orphanMutex;
+    static inline std::vector<Retired> orphans;
+
+public:
+    class Guard {
+    public:
+        Guard() {enter();};
+        ~Guard() {leave();};
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+    };
+
+    static void retire(void *pointer, void (*destroy)(void *), const void *owner) {
+        Local &l = local();
+        if (l.record == nullptr) {
+            l.record = acquire();
+        }
+        std::lock_guard<std::mutex> lock(l.record->retiredMutex);
+        l.record->retired.push_back({pointer, destroy, globalEpoch.load(), owner});
+        if (l.record->retired.size() % COLLECT_EVERY == 0) {
+            collect(l);
+        }
+    }
+
+    // frees everything retired from owner, on any thread, only when no thread can reach owner anymore
+    static void release(const void *owner) {
+        for (Record *r = records.load(); r != nullptr; r = r->next) {
+            std::lock_guard<std::mutex> lock(r->retiredMutex);
+            freeOwned(r->retired, owner);
+        }
+        std::lock_guard<std::mutex> lock(orphanMutex);
+        freeOwned(orphans, owner);
+    }
+
+private:
+    static Local &local() {
+        thread_local Local l;
+        return l;
+    }
+
+    static void enter() {
+        Local &l = local();
+        if (l.record == nullptr) {
+            l.record = acquire();
+        }
+        if (l.depth++ == 0) {
+            l.record->active.store(true);
+            l.record->epoch.store(globalEpoch.load());
+        }
+    }
+
+    static void leave() {
+        Local &l = local();
+        if (--l.depth == 0) {
+            l.record->active.store(false);
+        }
+    }
+
+    static Record *acquire() {
+        for (Record *r = records.load(); r != nullptr; r = r->next) {
+            bool expected = false;
+            if (!r->used.load() && r->used.compare_exchange_strong(expected, true)) {
+                return r;
+            }
+        }
+        Record *r = new Record();
+        r->used.store(true);
+        Record *head = records.load();
+        do {
+            r->next = head;
+        } while (!records.compare_exchange_weak(head, r));
+        return r;
+    }
+
+    // epoch can move on only when every thread inside a critical section has seen the current one
+    static void tryAdvance() {
+        uint64_t e = globalEpoch.load();
+        for (Record *r = records.load(); r != nullptr; r = r->next) {
+            if (r->active.load() && r->epoch.load() != e) {
+                return;
+            }
+        }
+        globalEpoch.compare_exchange_strong(e, e + 1);
+    }
+
+    static void freeOld(std::vector<Retired> &retired, uint64_t epoch) {
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++) {
+            if (retired[i].epoch + 2 <= epoch) {
+                retired[i].destroy(retired[i].pointer);
+            } else {
+                retired[kept++] = retired[i];
+            }
+        }
+        retired.resize(kept);
+    }
+
+    static void freeOwned(std::vector<Retired> &retired, const void *owner) {
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++) {
+            if (retired[i].owner == owner) {
+                retired[i].destroy(retired[i].pointer);
+            } else {
+                retired[kept++] = retired[i];
+            }
+        }
+        retired.resize(kept);
+    }
+
+    // retiredMutex of the record of l is held
+    static void collect(Local &l) {
+        tryAdvance();
+        uint64_t epoch = globalEpoch.load();
+        freeOld(l.record->retired, epoch);
+        std::unique_lock<std::mutex> lock(orphanMutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            freeOld(orphans, epoch);
+        }
+    }
+};
+
+// lock-free ordered set (skip list ordered by key like OrderedSet), safe to use from many threads at once
+template<class type> class ConcurrentOrderedSet {
+    static constexpr int MAX_LEVEL = 32;
+
+    class Node {
+        type data;
+        size_t key;
+        int height;
+        std::atomic<int> owners {2}; // inserting and removing thread, the last one retires the node
+        std::atomic<uintptr_t> links[1]; // height links, lowest bit set -> node is removed on that level
+        Node(type data, size_t key, int height) : data(data), key(key), height(height) {};
+    public:
+        static Node *create(type data, size_t key, int height) {
+            void *memory = ::operator new(sizeof(Node) + (height - 1) * sizeof(std::atomic<uintptr_t>));
+            Node *node = new (memory) Node(data, key, height);
+            for (int level = 1; level < height; level++) {
+                new (&node->links[level]) std::atomic<uintptr_t>(0);
+            }
+            return node;
+        }
+        static void destroy(void *pointer) {
+            Node *node = static_cast<Node*>(pointer);
+            node->~Node();
+            ::operator delete(pointer);
+        }
+        type getData() {return data;};
+        size_t getKey() {return key;};
+        int getHeight() {return height;};
+        std::atomic<uintptr_t> &next(int level) {return links[level];};
+        bool release() {return owners.fetch_sub(1) == 1;};
+    };
+
+    std::atomic<uintptr_t> head[MAX_LEVEL];
+    std::atomic<size_t> size {0};
+public:
+    ConcurrentOrderedSet() {
+        for (auto &link : head) {
+            link.store(0);
+        }
+    };
+    ConcurrentOrderedSet(const ConcurrentOrderedSet &) = delete;
+    ConcurrentOrderedSet &operator=(const ConcurrentOrderedSet &) = delete;
+    ~ConcurrentOrderedSet() { // no other thread can use the set anymore
+        Node *node = pointer(head[0].load());
+        while (node != nullptr) {
+            Node *next = pointer(node->next(0).load());
+            Node::destroy(node);
+            node = next;
+        }
+        EpochReclaimer::release(this); // removed nodes still waiting for their epoch
+    };
+
+    // weakly consistent iterator, sees elements present for the whole iteration, may or may not see concurrent changes
+    class Iterator {
+        friend ConcurrentOrderedSet<type>;
+
+        EpochReclaimer::Guard guard;
+        Node *node;
+        size_t last;
+    public:
+        Iterator(ConcurrentOrderedSet<type> *set, size_t first, size_t last) : node(set->lowerBound(first)), last(last) {
+            skipRemoved();
+        };
+
+        void operator++() {
+            if (node == nullptr) {
+                throw IndexOutOfRangeException();
+            }
+            node = pointer(node->next(0).load());
+            skipRemoved();
+        };
+
+        type getData() {return node->getData();}
+        bool finished() {return node != nullptr;};
+
+    private:
+        void skipRemoved() {
+            while (node != nullptr && isMarked(node->next(0).load())) {
+                node = pointer(node->next(0).load());
+            }
+            if (node != nullptr && node->getKey() > last) {
+                node = nullptr;
+            }
+        }
+    };
+
+    friend Iterator;
+    Iterator getIterator() {
+        return Iterator(this, 0, SIZE_MAX);
+    }
+    // elements from first to last (both included) in key order
+    Iterator getRangeIterator(type first, type last) {
+        return getRangeIterator(first, hash(first), last, hash(last)); // keys go through int, as in add
+    }
+    Iterator getRangeIterator(type first, int firstKey, type last, int lastKey) {
+        return Iterator(this, firstKey, lastKey);
+    }
+
+    template<typename... types>
+    void addMultiple(type value, types... values) {add(value); addMultiple(values...);};
+    void add(type value) { add(value, hash(value)); };
+    void add(type value, int key) {
+        EpochReclaimer::Guard guard;
+        std::atomic<uintptr_t> *preds[MAX_LEVEL];
+        Node *succs[MAX_LEVEL], *node = nullptr;
+        int height = randomHeight();
+        while (true) {
+            if (find(key, preds, succs)) {
+                if (node != nullptr) {
+                    Node::destroy(node); // never published
+                }
+                return;
+            }
+            if (node == nullptr) {
+                node = Node::create(value, key, height);
+            }
+            for (int level = 0; level < height; level++) {
+                node->next(level).store(link(succs[level]));
+            }
+            uintptr_t expected = link(succs[0]);
+            size++; // before the node is visible, a remover that finds it at once must not take size below 0
+            if (preds[0]->compare_exchange_strong(expected, link(node))) {
+                break;
+            }
+            size--;
+        }
+        for (int level = 1; level < height && linkLevel(node, level, preds, succs); level++);
+        if (isMarked(node->next(0).load())) {
+            find(key, preds, succs); // removed while we were linking, unlink what we linked after the remover did
+        }
+        if (node->release()) {
+            EpochReclaimer::retire(node, &Node::destroy, this);
+        }
+    };
+
+    void remove(type value) { remove(value, hash(value)); };
+    void remove(type value, int key) {
+        if (!tryRemove(value, key)) {
+            throw ValueNotFoundException();
+        }
+    };
+    // false if value is not in set, which is not exceptional when other threads remove the same values
+    bool tryRemove(type value) { return tryRemove(value, hash(value)); };
+    bool tryRemove(type value, int key) {
+        EpochReclaimer::Guard guard;
+        std::atomic<uintptr_t> *preds[MAX_LEVEL];
+        Node *succs[MAX_LEVEL];
+        if (!find(key, preds, succs)) {
+            return false;
+        }
+        Node *node = succs[0];
+        for (int level = node->getHeight() - 1; level > 0; level--) {
+            node->next(level).fetch_or(1);
+        }
+        if (isMarked(node->next(0).fetch_or(1))) {
+            return false; // other thread removed it first
+        }
+        size--;
+        find(key, preds, succs); // unlinks node on every level
+        if (node->release()) {
+            EpochReclaimer::retire(node, &Node::destroy, this);
+        }
+        return true;
+    };
+
+    bool contains(type value) { return contains(value, hash(value)); };
+    bool contains(type value, int key) {
+        EpochReclaimer::Guard guard;
+        Node *node = lowerBound(key);
+        return node != nullptr && node->getKey() == (size_t) key && !isMarked(node->next(0).load());
+    };
+
+    size_t getSize() {return size.load();}
+    type min() {
+        EpochReclaimer::Guard guard;
+        Node *node = pointer(head[0].load());
+        while (node != nullptr && isMarked(node->next(0).load())) {
+            node = pointer(node->next(0).load());
+        }
+        if (node == nullptr) {
+            throw EmptySetException();
+        }
+        return node->getData();
+    };
+
+    // expected rank of value, every step right on level l skips about 2^l elements
+    size_t getApproximateIndex(type value) {return getApproximateIndex(value, hash(value));}
+    size_t getApproximateIndex(type value, int key) {
+        EpochReclaimer::Guard guard;
+        size_t index = 0;
+        Node *pred = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+            Node *node = pointer(linkOf(pred, level).load());
+            while (node != nullptr && node->getKey() < (size_t) key) {
+                index += size_t(1) << level;
+                pred = node;
+                node = pointer(node->next(level).load());
+            }
+        }
+        return std::min(index, getSize());
+    };
+
+private:
+
+    void addMultiple() {};
+
+    static bool isMarked(uintptr_t link) {return link & 1;}
+    static Node *pointer(uintptr_t link) {return reinterpret_cast<Node*>(link & ~uintptr_t(1));}
+    static uintptr_t link(Node *node) {return reinterpret_cast<uintptr_t>(node);}
+    std::atomic<uintptr_t> &linkOf(Node *pred, int level) {return (pred == nullptr) ? head[level] : pred->next(level);}
+
+    static int randomHeight() {
+        thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return 1 + __builtin_ctzll(state | (uint64_t(1) << (MAX_LEVEL - 1))); // p = 1/2 per level
+    }
+
+    // first node with key >= key on the bottom level, removed nodes included
+    Node *lowerBound(size_t key) {
+        Node *pred = nullptr, *node = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+            node = pointer(linkOf(pred, level).load());
+            while (node != nullptr && node->getKey() < key) {
+                pred = node;
+                node = pointer(node->next(level).load());
+            }
+        }
+        return node;
+    }
+
+    // fills links before and nodes after key on every level, unlinks removed nodes on the way
+    bool find(size_t key, std::atomic<uintptr_t> **preds, Node **succs) {
+        while (!tryFind(key, preds, succs));
+        return succs[0] != nullptr && succs[0]->getKey() == key;
+    }
+
+    bool tryFind(size_t key, std::atomic<uintptr_t> **preds, Node **succs) {
+        Node *pred = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+            std::atomic<uintptr_t> *predLink = &linkOf(pred, level);
+            Node *node = pointer(predLink->load());
+            while (node != nullptr) {
+                uintptr_t next = node->next(level).load();
+                if (isMarked(next)) {
+                    uintptr_t expected = link(node);
+                    if (!predLink->compare_exchange_strong(expected, next & ~uintptr_t(1))) {
+                        return false; // pred changed or got removed, start again
+                    }
+                    node = pointer(next);
+                    continue;
+                }
+                if (node->getKey() >= key) {
+                    break;
+                }
+                pred = node;
+                predLink = &node->next(level);
+                node = pointer(next);
+            }
+            preds[level] = predLink;
+            succs[level] = node;
+        }
+        return true;
+    }
+
+    // links node on level, false if it got removed in the meantime
+    bool linkLevel(Node *node, int level, std::atomic<uintptr_t> **preds, Node **succs) {
+        while (true) {
+            uintptr_t next = node->next(level).load();
+            if (isMarked(next)) {
+                return false;
+            }
+            if (next != link(succs[level]) && !node->next(level).compare_exchange_strong(next, link(succs[level]))) {
+                continue;
+            }
+            uintptr_t expected = link(succs[level]);
+            if (preds[level]->compare_exchange_strong(expected, link(node))) {
+                return true;
+            }
+            find(node->getKey(), preds, succs);
+            if (succs[0] != node) {
+                return false;
+            }
+        }
+    }
+
+    template <typename Integer,
+            std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+    size_t hash(Integer &key) { return key; };
+    template <typename Floating,
+            std::enable_if_t<std::is_floating_point<Floating>::value, bool> = true>
+    size_t hash(Floating &key) {
+        size_t result = 0;
+        memcpy(&result, &key, sizeof(Floating));
+        return result & 0xfffff000;
+    };
+    size_t hash(const char* key) {
+        unsigned h = 0;
+        while (*key) {
+            h = h * 101 + (unsigned) *key++;
+        }
+        return h;
+    };
+    size_t hash(const std::string key) {
+        unsigned h = 0;
+        const char *a = key.c_str();
+        while (*a) {
+            h = h * 101 + (unsigned) *a++;
+        }
+        return h;
+    };
+};
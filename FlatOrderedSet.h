@@ -0,0 +1,239 @@
+#pragma once
+
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Exceptions.h"
+#include "OrderedSet.h"
+
+// read only ordered set, elements are stored in one array in Eytzinger (BFS) order of an implicit complete tree
+template<class type, class Compare = HashOrder> class FlatOrderedSet {
+    static constexpr bool HASH_ORDERED = std::is_same<Compare, HashOrder>::value;
+    static constexpr size_t PREFETCH_AHEAD = 8; // 64B cache line of keys -> 3 levels down
+
+    size_t size;
+    std::vector<size_t> keys; // only for HashOrder, both arrays are 1-indexed
+    std::vector<type> values;
+public:
+    // sortedList has to be sorted in the order of the set (same as getSortedList of OrderedSet)
+    FlatOrderedSet(type *sortedList, size_t size) : size(size), keys(HASH_ORDERED ? size + 1 : 0), values(size + 1) {
+        size_t i = 0;
+        fill(1, [&](size_t k) {
+            values[k] = sortedList[i];
+            if constexpr (HASH_ORDERED) {
+                keys[k] = size_t(int(hash(sortedList[i]))); // keys go through int, as in OrderedSet::add
+            }
+            i++;
+        });
+    };
+
+    template<class Aggregate>
+    explicit FlatOrderedSet(OrderedSet<type, Compare, Aggregate> set) : size(set.getSize()), keys(HASH_ORDERED ? size + 1 : 0), values(size + 1) {
+        typename OrderedSet<type, Compare, Aggregate>::Cursor cursor(set);
+        fill(1, [&](size_t k) {
+            values[k] = cursor.getNode()->getData();
+            if constexpr (HASH_ORDERED) {
+                keys[k] = cursor.getNode()->getKey();
+            }
+            ++cursor;
+        });
+    };
+
+    class Iterator {
+        friend FlatOrderedSet<type, Compare>;
+
+        size_t k;
+        FlatOrderedSet<type, Compare> *set;
+    public:
+        explicit Iterator(FlatOrderedSet<type, Compare> *set) : k(set->select(0)), set(set) {};
+
+        void operator++() {
+            if (k == 0) {
+                throw IndexOutOfRangeException();
+            }
+            k = set->successor(k);
+        };
+
+        type getData() {return set->values[k];}
+        bool finished() {return k != 0;};
+    };
+
+    friend Iterator;
+    Iterator getIterator() {
+        return Iterator(this);
+    }
+
+    bool contains(type value) {return contains(value, keyOf(value));};
+    bool contains(type value, int key) {return find(value, key) != 0;};
+
+    size_t getSize() {return size;}
+    type min() {
+        if (size == 0) {
+            throw EmptySetException();
+        }
+        return values[select(0)];
+    };
+    type max() {
+        if (size == 0) {
+            throw EmptySetException();
+        }
+        return values[select(size - 1)];
+    };
+    type *getSortedList() {
+        type *listToReturn = new type[size];
+        int j = 0;
+        for (auto iter = getIterator(); iter.finished(); ++iter) {
+            listToReturn[j] = iter.getData();
+            j++;
+        }
+        return listToReturn;
+    };
+
+    type getItem(size_t index) {
+        if (index >= size) {
+            throw IndexOutOfRangeException();
+        }
+        return values[select(index)];
+    };
+    size_t getIndex(type value) {return getIndex(value, keyOf(value));}
+    size_t getIndex(type value, int key) {
+        size_t k = find(value, key);
+        if (k == 0) {
+            throw ValueNotFoundException();
+        }
+        return rank(k);
+    };
+
+private:
+
+    // in-order walk of the implicit tree, calls place with slots in sorted order
+    template<typename Function>
+    void fill(size_t k, Function &&place) {
+        if (k <= size) {
+            fill(2 * k, place);
+            place(k);
+            fill(2 * k + 1, place);
+        }
+    }
+
+    // branchless descent, returns slot of the first element >= value (or 0)
+    size_t lowerBound(type &value, size_t key) {
+        size_t k = 1;
+        while (k <= size) {
+            if constexpr (HASH_ORDERED) {
+                __builtin_prefetch(keys.data() + PREFETCH_AHEAD * k);
+                k = 2 * k + (keys[k] < key);
+            } else {
+                __builtin_prefetch(values.data() + PREFETCH_AHEAD * k);
+                k = 2 * k + Compare()(values[k], value);
+            }
+        }
+        return k >> __builtin_ffsll(~k); // undo the right turns taken after the last left one
+    }
+
+    size_t find(type &value, size_t key) {
+        size_t k = lowerBound(value, key);
+        if (k == 0) {
+            return 0;
+        }
+        if constexpr (HASH_ORDERED) {
+            return (keys[k] == key) ? k : 0;
+        } else {
+            return Compare()(value, values[k]) ? 0 : k;
+        }
+    }
+
+    static size_t depth(size_t k) {return 63 - __builtin_clzll(k);}
+
+    // size of subtree of slot k, all levels but the last one are full
+    size_t subtreeSize(size_t k) {
+        if (k > size) {
+            return 0;
+        }
+        size_t levels = depth(size) - depth(k); // levels below k
+        size_t full = (size_t(1) << levels) - 1, first = k << levels;
+        size_t last = (size < first) ? 0 : std::min(size - first + 1, size_t(1) << levels);
+        return full + last;
+    }
+
+    // sorted position of slot k, every right turn on the way from root skips left subtree and its parent
+    size_t rank(size_t k) {
+        size_t r = subtreeSize(2 * k);
+        for (; k > 1; k >>= 1) {
+            if (k & 1) {
+                r += subtreeSize(k - 1) + 1;
+            }
+        }
+        return r;
+    }
+
+    // slot of sorted position index, 0 if out of range
+    size_t select(size_t index) {
+        size_t k = 1;
+        while (k <= size) {
+            size_t left = subtreeSize(2 * k);
+            if (index == left) {
+                return k;
+            }
+            if (index < left) {
+                k = 2 * k;
+            } else {
+                index -= left + 1;
+                k = 2 * k + 1;
+            }
+        }
+        return 0;
+    }
+
+    // in-order successor of slot k, 0 after the last one
+    size_t successor(size_t k) {
+        if (2 * k + 1 <= size) {
+            k = 2 * k + 1;
+            while (2 * k <= size) {
+                k = 2 * k;
+            }
+            return k;
+        }
+        while (k & 1) {
+            k >>= 1;
+        }
+        return k >> 1;
+    }
+
+    size_t keyOf(type &value) {
+        if constexpr (HASH_ORDERED) {
+            return hash(value);
+        } else {
+            return 0;
+        }
+    };
+
+    template <typename Integer,
+            std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+    size_t hash(Integer &key) { return key; };
+    template <typename Floating,
+            std::enable_if_t<std::is_floating_point<Floating>::value, bool> = true>
+    size_t hash(Floating &key) {
+        size_t result = 0;
+        memcpy(&result, &key, sizeof(Floating));
+        return result & 0xfffff000;
+    };
+    size_t hash(const char* key) {
+        unsigned h = 0;
+        while (*key) {
+            h = h * 101 + (unsigned) *key++;
+        }
+        return h;
+    };
+    size_t hash(const std::string key) {
+        unsigned h = 0;
+        const char *a = key.c_str();
+        while (*a) {
+            h = h * 101 + (unsigned) *a++;
+        }
+        return h;
+    };
+};
@@ -0,0 +1,428 @@
+#pragma once
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Exceptions.h"
+
+// ordered set of unsigned integers up to 32 bits, a van Emde Boas layout with the recursion unrolled:
+// 16 high bits pick a cluster, its 8 high bits pick a 256 bit leaf, summaries find the next non empty part,
+// so every operation is a constant number of word scans instead of a tree descent, clusters are reached through
+// a directory of 256 pages of 256 clusters, both made on first use: a set with elements costs 3 KB for the directory
+// and 3 KB for every page in use (2^24 values each), so from 6 KB for small keys up to 772 KB for keys in all pages
+template<class type = uint32_t> class IntegerOrderedSet {
+    static_assert(std::is_integral<type>::value && std::is_unsigned<type>::value && sizeof(type) <= sizeof(uint32_t),
+                  "IntegerOrderedSet holds unsigned integers up to 32 bits");
+    static constexpr size_t FANOUT = 256; // pages in the directory, clusters in a page
+
+    // 256 bits, positions are 0 to 255, -1 means none
+    struct Bits {
+        uint64_t words[4] = {};
+
+        bool test(unsigned i) {return (words[i >> 6] >> (i & 63)) & 1;};
+        void set(unsigned i) {words[i >> 6] |= uint64_t(1) << (i & 63);};
+        void reset(unsigned i) {words[i >> 6] &= ~(uint64_t(1) << (i & 63));};
+        bool empty() {return (words[0] | words[1] | words[2] | words[3]) == 0;};
+        int min() {return next(-1);};
+        int max() {return previous(256);};
+        // first position > i
+        int next(int i) {
+            for (unsigned w = (i + 1) >> 6; w < 4; w++) {
+                uint64_t word = words[w];
+                if (w == unsigned(i + 1) >> 6) {
+                    word &= ~uint64_t(0) << ((i + 1) & 63);
+                }
+                if (word != 0) {
+                    return w * 64 + __builtin_ctzll(word);
+                }
+            }
+            return -1;
+        };
+        // last position < i
+        int previous(int i) {
+            for (int w = (i - 1) >> 6; w >= 0; w--) {
+                uint64_t word = words[w];
+                if (w == (i - 1) >> 6 && ((i - 1) & 63) != 63) {
+                    word &= (uint64_t(1) << (((i - 1) & 63) + 1)) - 1;
+                }
+                if (word != 0) {
+                    return w * 64 + 63 - __builtin_clzll(word);
+                }
+            }
+            return -1;
+        };
+        // number of positions < i
+        unsigned rank(unsigned i) {
+            unsigned r = 0;
+            for (unsigned w = 0; w < (i >> 6); w++) {
+                r += __builtin_popcountll(words[w]);
+            }
+            if ((i & 63) != 0) {
+                r += __builtin_popcountll(words[i >> 6] & ((uint64_t(1) << (i & 63)) - 1));
+            }
+            return r;
+        };
+        // position of the index-th set bit, there have to be more than index bits
+        unsigned select(unsigned index) {
+            unsigned w = 0;
+            for (unsigned c = __builtin_popcountll(words[0]); index >= c; c = __builtin_popcountll(words[w])) {
+                index -= c;
+                w++;
+            }
+            uint64_t word = words[w];
+            for (; index > 0; index--) {
+                word &= word - 1;
+            }
+            return w * 64 + __builtin_ctzll(word);
+        };
+    };
+
+    // 16 bit universe, leaves are stored densely in the order of their bits in summary
+    class Cluster {
+        Bits summary;
+        std::vector<Bits> leaves;
+        std::vector<uint8_t> fill; // elements in each leaf minus one, rank and select read these instead of leaves
+        uint32_t size = 0;
+    public:
+        bool add(unsigned x) {
+            unsigned high = x >> 8, slot = summary.rank(high);
+            if (!summary.test(high)) {
+                summary.set(high);
+                leaves.insert(leaves.begin() + slot, Bits());
+                fill.insert(fill.begin() + slot, 255); // wraps to 0 below
+            }
+            if (leaves[slot].test(x & 255)) {
+                return false;
+            }
+            leaves[slot].set(x & 255);
+            fill[slot]++;
+            size++;
+            return true;
+        };
+        bool remove(unsigned x) {
+            unsigned high = x >> 8, slot = summary.rank(high);
+            if (!summary.test(high) || !leaves[slot].test(x & 255)) {
+                return false;
+            }
+            leaves[slot].reset(x & 255);
+            if (leaves[slot].empty()) {
+                summary.reset(high);
+                leaves.erase(leaves.begin() + slot);
+                fill.erase(fill.begin() + slot);
+            } else {
+                fill[slot]--;
+            }
+            size--;
+            return true;
+        };
+        bool contains(unsigned x) {
+            unsigned high = x >> 8;
+            return summary.test(high) && leaves[summary.rank(high)].test(x & 255);
+        };
+        bool empty() {return size == 0;};
+        uint32_t getSize() {return size;};
+        unsigned min() {return (unsigned(summary.min()) << 8) | leaves.front().min();};
+        unsigned max() {return (unsigned(summary.max()) << 8) | leaves.back().max();};
+        // first element > x, -1 if none
+        int next(unsigned x) {
+            unsigned high = x >> 8, slot = summary.rank(high);
+            if (summary.test(high)) {
+                int low = leaves[slot].next(x & 255);
+                if (low >= 0) {
+                    return (high << 8) | low;
+                }
+                slot++;
+            }
+            int nextHigh = summary.next(high);
+            return (nextHigh < 0) ? -1 : (nextHigh << 8) | leaves[slot].min();
+        };
+        // last element < x, -1 if none
+        int previous(unsigned x) {
+            unsigned high = x >> 8, slot = summary.rank(high);
+            if (summary.test(high)) {
+                int low = leaves[slot].previous(x & 255);
+                if (low >= 0) {
+                    return (high << 8) | low;
+                }
+            }
+            int previousHigh = summary.previous(high);
+            return (previousHigh < 0) ? -1 : (previousHigh << 8) | leaves[slot - 1].max();
+        };
+        // number of elements < x
+        uint32_t rank(unsigned x) {
+            unsigned high = x >> 8, slot = summary.rank(high);
+            uint32_t r = slot;
+            for (unsigned i = 0; i < slot; i++) {
+                r += fill[i];
+            }
+            return summary.test(high) ? r + leaves[slot].rank(x & 255) : r;
+        };
+        unsigned select(uint32_t index) {
+            unsigned slot = 0;
+            for (unsigned c = fill[0] + 1u; index >= c; c = fill[slot] + 1u) {
+                index -= c;
+                slot++;
+            }
+            return (summary.select(slot) << 8) | leaves[slot].select(index);
+        };
+    };
+
+    // clusters with the same high 8 of their 16 bits, counts[FANOUT] is the size of the whole page
+    struct Page {
+        Cluster *clusters[FANOUT] = {};
+        uint32_t counts[FANOUT + 1] = {}; // Fenwick tree of cluster sizes for rank, 1-indexed
+    };
+    struct Directory {
+        Page *pages[FANOUT] = {};
+        uint32_t counts[FANOUT + 1] = {}; // Fenwick tree of page sizes for rank, 1-indexed
+    };
+
+    Directory *directory; // lazily allocated
+    Cluster summary; // non empty clusters
+    size_t size;
+public:
+    explicit IntegerOrderedSet() : directory(nullptr), size(0) {};
+    IntegerOrderedSet(const IntegerOrderedSet<type> &set) : directory(nullptr), summary(set.summary), size(set.size) {
+        if (set.directory != nullptr) {
+            directory = new Directory(*set.directory);
+            for (int high = summary.empty() ? -1 : int(summary.min()); high >= 0; high = summary.next(high)) {
+                Page *&page = directory->pages[high >> 8];
+                if (page == set.directory->pages[high >> 8]) { // first cluster of the page
+                    page = new Page(*page);
+                }
+                page->clusters[high & 255] = new Cluster(*page->clusters[high & 255]);
+            }
+        }
+    };
+    IntegerOrderedSet<type> &operator=(IntegerOrderedSet<type> set) {
+        std::swap(directory, set.directory);
+        std::swap(summary, set.summary);
+        std::swap(size, set.size);
+        return *this;
+    };
+    ~IntegerOrderedSet() {
+        clear();
+    };
+
+    class Iterator {
+        friend IntegerOrderedSet<type>;
+
+        IntegerOrderedSet<type> *set;
+        int64_t current; // -1 when finished
+    public:
+        explicit Iterator(IntegerOrderedSet<type> *set) : set(set), current(set->size == 0 ? -1 : set->min()) {};
+
+        void operator++() {
+            if (current < 0) {
+                throw IndexOutOfRangeException();
+            }
+            current = set->nextOf(current);
+        };
+
+        type getData() {return type(current);}
+        bool finished() {return current >= 0;};
+    };
+
+    friend Iterator;
+    Iterator getIterator() {
+        return Iterator(this);
+    }
+
+    void clear() {
+        if (directory != nullptr) {
+            while (!summary.empty()) {
+                unsigned high = summary.min();
+                delete directory->pages[high >> 8]->clusters[high & 255];
+                summary.remove(high);
+            }
+            for (Page *page : directory->pages) {
+                delete page;
+            }
+            delete directory;
+            directory = nullptr;
+        }
+        size = 0;
+    };
+
+    template<typename... types>
+    void addMultiple(type value, types... values) {add(value); addMultiple(values...);};
+    void add(type value) {
+        if (directory == nullptr) {
+            directory = new Directory();
+        }
+        uint32_t x = value, high = x >> 16;
+        Page *&page = directory->pages[high >> 8];
+        if (page == nullptr) {
+            page = new Page();
+        }
+        Cluster *&cluster = page->clusters[high & 255];
+        if (cluster == nullptr) {
+            cluster = new Cluster();
+            summary.add(high);
+        }
+        if (cluster->add(x & 0xffff)) {
+            countAdd(high, 1);
+            size++;
+        }
+    };
+
+    void remove(type value) {
+        uint32_t x = value, high = x >> 16;
+        Cluster *cluster = clusterOf(high);
+        if (cluster == nullptr || !cluster->remove(x & 0xffff)) {
+            throw ValueNotFoundException();
+        }
+        countAdd(high, -1);
+        size--;
+        if (cluster->empty()) {
+            Page *&page = directory->pages[high >> 8];
+            delete cluster;
+            page->clusters[high & 255] = nullptr;
+            summary.remove(high);
+            if (page->counts[FANOUT] == 0) {
+                delete page;
+                page = nullptr;
+            }
+        }
+    };
+
+    bool contains(type value) {
+        uint32_t x = value;
+        Cluster *cluster = clusterOf(x >> 16);
+        return cluster != nullptr && cluster->contains(x & 0xffff);
+    };
+
+    size_t getSize() {return size;}
+    type min() {
+        if (size == 0) {
+            throw EmptySetException();
+        }
+        unsigned high = summary.min();
+        return type((high << 16) | clusterOf(high)->min());
+    };
+    type max() {
+        if (size == 0) {
+            throw EmptySetException();
+        }
+        unsigned high = summary.max();
+        return type((high << 16) | clusterOf(high)->max());
+    };
+
+    // smallest element bigger than value, value does not have to be in the set
+    type successor(type value) {
+        int64_t next = nextOf(value);
+        if (next < 0) {
+            throw ValueNotFoundException();
+        }
+        return type(next);
+    };
+    // biggest element smaller than value
+    type predecessor(type value) {
+        if (size == 0) {
+            throw ValueNotFoundException();
+        }
+        uint32_t x = value, high = x >> 16;
+        Cluster *cluster = clusterOf(high);
+        if (cluster != nullptr) {
+            int low = cluster->previous(x & 0xffff);
+            if (low >= 0) {
+                return type((high << 16) | low);
+            }
+        }
+        int previousHigh = summary.previous(high);
+        if (previousHigh < 0) {
+            throw ValueNotFoundException();
+        }
+        return type((uint32_t(previousHigh) << 16) | clusterOf(previousHigh)->max());
+    };
+
+    type *getSortedList() {
+        type *listToReturn = new type[size];
+        int j = 0;
+        for (auto iter = getIterator(); iter.finished(); ++iter) {
+            listToReturn[j] = iter.getData();
+            j++;
+        }
+        return listToReturn;
+    };
+
+    type getItem(size_t index) {
+        if (index >= size) {
+            throw IndexOutOfRangeException();
+        }
+        uint32_t page = treeFind(directory->counts, index), entry = treeFind(directory->pages[page]->counts, index);
+        return type((((page << 8) | entry) << 16) | directory->pages[page]->clusters[entry]->select(index));
+    };
+    size_t getIndex(type value) {
+        if (!contains(value)) {
+            throw ValueNotFoundException();
+        }
+        uint32_t x = value, high = x >> 16;
+        return countsBefore(high) + clusterOf(high)->rank(x & 0xffff);
+    };
+
+private:
+
+    void addMultiple() {};
+
+    // nullptr if the cluster of the high 16 bits is empty
+    Cluster *clusterOf(uint32_t high) {
+        if (directory == nullptr || directory->pages[high >> 8] == nullptr) {
+            return nullptr;
+        }
+        return directory->pages[high >> 8]->clusters[high & 255];
+    }
+
+    // first element > x, -1 if none
+    int64_t nextOf(uint32_t x) {
+        if (size == 0) {
+            return -1;
+        }
+        uint32_t high = x >> 16;
+        Cluster *cluster = clusterOf(high);
+        if (cluster != nullptr) {
+            int low = cluster->next(x & 0xffff);
+            if (low >= 0) {
+                return (high << 16) | low;
+            }
+        }
+        int nextHigh = summary.next(high);
+        return (nextHigh < 0) ? -1 : int64_t((uint32_t(nextHigh) << 16) | clusterOf(nextHigh)->min());
+    }
+
+    void countAdd(size_t high, int delta) {
+        treeAdd(directory->counts, high >> 8, delta);
+        treeAdd(directory->pages[high >> 8]->counts, high & 255, delta);
+    }
+    static void treeAdd(uint32_t *counts, size_t slot, int delta) {
+        for (size_t i = slot + 1; i <= FANOUT; i += i & (0 - i)) {
+            counts[i] += delta;
+        }
+    }
+
+    size_t countsBefore(size_t high) {
+        return treeBefore(directory->counts, high >> 8) + treeBefore(directory->pages[high >> 8]->counts, high & 255);
+    }
+    static size_t treeBefore(uint32_t *counts, size_t slot) {
+        size_t r = 0;
+        for (size_t i = slot; i > 0; i -= i & (0 - i)) {
+            r += counts[i];
+        }
+        return r;
+    }
+
+    // Fenwick descent to the slot holding the index-th element, index becomes the position inside that slot
+    static size_t treeFind(uint32_t *counts, size_t &index) {
+        size_t slot = 0;
+        for (size_t step = FANOUT; step > 0; step >>= 1) {
+            if (slot + step <= FANOUT && counts[slot + step] <= index) {
+                slot += step;
+                index -= counts[slot];
+            }
+        }
+        return slot;
+    }
+};
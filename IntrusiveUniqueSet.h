@@ -0,0 +1,144 @@
+#pragma once
+
+#include <iostream>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include "Exceptions.h"
+
+// embedded in the elements of IntrusiveUniqueSet, remembers which set holds the object and where,
+// an object needs one hook for every set it should be in at the same time
+class UniqueSetHook {
+    template<class type, UniqueSetHook type::*hook> friend class IntrusiveUniqueSet;
+
+    void *owner = nullptr;
+    size_t slot = 0;
+public:
+    UniqueSetHook() = default;
+    // a copied object is a new object, it is not in any set
+    UniqueSetHook(const UniqueSetHook &) {};
+    UniqueSetHook &operator=(const UniqueSetHook &) {return *this;};
+
+    bool isLinked() {return owner != nullptr;};
+};
+
+// UniqueSet for objects that carry a UniqueSetHook (the member hook points to), the set is a dense array of
+// pointers and the hook knows the position of its object in it, so add, remove and contains are O(1), with no
+// hashing and no allocation besides growing the array, objects have to stay alive while they are in the set
+template<class type, UniqueSetHook type::*hook = &type::uniqueSetHook> class IntrusiveUniqueSet {
+    const int MULTIPLY_SIZE_BY = 2;
+
+    size_t capacity = 0;
+    size_t size = 0;
+    type **list;
+public:
+    explicit IntrusiveUniqueSet(size_t startingCapacity = 10) {
+        list = new type* [startingCapacity == 0 ? 1 : startingCapacity];
+        capacity = startingCapacity == 0 ? 1 : startingCapacity;
+    };
+    // hooks can point to one set only
+    IntrusiveUniqueSet(const IntrusiveUniqueSet<type, hook> &) = delete;
+    IntrusiveUniqueSet<type, hook> &operator=(const IntrusiveUniqueSet<type, hook> &) = delete;
+    ~IntrusiveUniqueSet() {
+        clear();
+        delete[] list;
+    };
+
+    class Iterator {
+        friend IntrusiveUniqueSet<type, hook>;
+
+        IntrusiveUniqueSet<type, hook> *set;
+        size_t i;
+    public:
+        explicit Iterator(IntrusiveUniqueSet<type, hook> *set) : set(set), i(0) {};
+
+        void operator++() {
+            if (i >= set->size) {
+                throw IndexOutOfRangeException();
+            }
+            i++;
+        };
+
+        type getData() {
+            if (i >= set->size) {
+                throw EmptySetException();
+            }
+            return *set->list[i];
+        }
+        type *getPointer() {
+            if (i >= set->size) {
+                throw EmptySetException();
+            }
+            return set->list[i];
+        }
+        bool finished() {return i < set->size;};
+    };
+
+    friend Iterator;
+    Iterator getIterator() {
+        return Iterator(this);
+    }
+
+    void clear() {
+        for (size_t i = 0; i < size; i++) {
+            (list[i]->*hook).owner = nullptr;
+        }
+        size = 0;
+    };
+
+    template<typename... types>
+    void addMultiple(type &value, types&... values) {add(value); addMultiple(values...);};
+    // OccupiedSpaceException if the hook is already used by another set
+    void add(type &value) {
+        UniqueSetHook &link = value.*hook;
+        if (link.owner == this) {
+            return;
+        }
+        if (link.owner != nullptr) {
+            throw OccupiedSpaceException();
+        }
+        if (size == capacity) {
+            resize(capacity * MULTIPLY_SIZE_BY);
+        }
+        link.owner = this;
+        link.slot = size;
+        list[size++] = &value;
+    };
+
+    // the last element takes the place of the removed one
+    void remove(type &value) {
+        UniqueSetHook &link = value.*hook;
+        if (link.owner != this) {
+            throw ValueNotFoundException();
+        }
+        type *last = list[--size];
+        list[link.slot] = last;
+        (last->*hook).slot = link.slot;
+        link.owner = nullptr;
+    };
+
+    bool contains(type &value) {return (value.*hook).owner == this;};
+
+    size_t getSize() {return size;}
+    size_t getCapacity() {return capacity;}
+    type *getList() {
+        type *listToReturn = new type[size];
+        for (size_t i = 0; i < size; i++) {
+            listToReturn[i] = *list[i];
+        }
+        return listToReturn;
+    };
+
+private:
+
+    void addMultiple() {};
+
+    void resize(const size_t &newCapacity) {
+        type **oldList = list;
+        list = new type* [newCapacity];
+        std::copy(oldList, oldList + size, list);
+        capacity = newCapacity;
+        delete[] oldList;
+    };
+};
\ No newline at end of file
@@ -5,261 +5,746 @@
 #include <cmath>
 #include <stdexcept>
 #include <type_traits>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <future>
+#include <thread>
+#include <vector>
 #include "Exceptions.h"
+#include "ArrayView.h"
 
-template<class type> class OrderedSet {
+// aggregates are monoids kept in every node over its subtree, combine has to be associative
+template<class type> struct NoAggregate {
+    struct value_type {};
+    static value_type identity() {return {};};
+    static value_type of(const type &) {return {};};
+    static value_type combine(const value_type &, const value_type &) {return {};};
+};
 
-    class Node {
+template<class type> struct SumAggregate {
+    using value_type = type;
+    static value_type identity() {return type();};
+    static value_type of(const type &value) {return value;};
+    static value_type combine(const value_type &a, const value_type &b) {return a + b;};
+};
+
+template<class type> struct MinAggregate {
+    using value_type = type;
+    static value_type identity() {return std::numeric_limits<type>::max();};
+    static value_type of(const type &value) {return value;};
+    static value_type combine(const value_type &a, const value_type &b) {return std::min(a, b);};
+};
+
+template<class type> struct MaxAggregate {
+    using value_type = type;
+    static value_type identity() {return std::numeric_limits<type>::lowest();};
+    static value_type of(const type &value) {return value;};
+    static value_type combine(const value_type &a, const value_type &b) {return std::max(a, b);};
+};
+
+// default order of OrderedSet, by key (hash of value, or key given by user), meaningful mostly for numbers
+struct HashOrder {};
+
+// order for c strings by value, to be used as OrderedSet<char *, CStringLess>
+struct CStringLess {
+    bool operator()(const char *a, const char *b) const {return strcmp(a, b) < 0;};
+};
+
+// NoAggregate takes no space in nodes
+template<class summary, bool = std::is_empty<summary>::value> class AggregateSlot {
+    summary value;
+public:
+    summary getSummary() {return value;};
+    void setSummary(summary s) {value=s;};
+};
+
+template<class summary> class AggregateSlot<summary, true> {
+public:
+    summary getSummary() {return summary();};
+    void setSummary(summary s) {};
+};
+
+template<class type, class Compare> class FlatOrderedSet;
+template<class type, class Compare> class AdaptiveOrderedSet;
+
+template<class type, class Compare = HashOrder, class Aggregate = NoAggregate<type>> class OrderedSet {
+    template<class, class> friend class FlatOrderedSet;
+    template<class, class> friend class AdaptiveOrderedSet;
+    static constexpr bool HASH_ORDERED = std::is_same<Compare, HashOrder>::value;
+    using Summary = typename Aggregate::value_type;
+    static constexpr bool AGGREGATED = !std::is_empty<Summary>::value;
+    static constexpr size_t BALANCE_PERCENT = 29; // weight balance parameter alpha (in %) used by join
+    static constexpr size_t PARALLEL_GRAIN = 4096; // smaller set operations are not worth a new thread
+    static constexpr size_t BATCH_LANES = 16; // descents in flight in a batch lookup, enough to hide a memory access
+
+    class NodePool;
+
+    // links are 32 bit indices into the NodePool of the set, 0 is null
+    class Node : public AggregateSlot<Summary> {
         type data;
-        size_t key, size;
-        Node *left = nullptr, *right = nullptr;
+        size_t key;
+        uint32_t size = 1, left = 0, right = 0, index;
     public:
-        Node(type data, size_t key) : data(data), key(key), size(1) {};
-        bool operator==(Node &node) {return key == node.key;};
-        bool operator<(Node &node) {return key < node.key;};
+        Node(type data, size_t key, uint32_t index = 0) : data(data), key(key), index(index) {
+            this->setSummary(Aggregate::of(data));
+        };
+        bool operator==(Node &node) {
+            if constexpr (HASH_ORDERED) {
+                return key == node.key;
+            } else {
+                return !Compare()(data, node.data) && !Compare()(node.data, data);
+            }
+        };
+        bool operator<(Node &node) {
+            if constexpr (HASH_ORDERED) {
+                return key < node.key;
+            } else {
+                return Compare()(data, node.data);
+            }
+        };
+        // same as == and > against a value that has no node of its own
+        bool same(type &value, size_t valueKey) {
+            if constexpr (HASH_ORDERED) {
+                return key == valueKey;
+            } else {
+                return !Compare()(data, value) && !Compare()(value, data);
+            }
+        };
+        bool after(type &value, size_t valueKey) {
+            if constexpr (HASH_ORDERED) {
+                return valueKey < key;
+            } else {
+                return Compare()(value, data);
+            }
+        };
         void operator++() {size++;};
         void operator--() {size--;};
         type getData() {return data;};
         size_t getKey() {return key;};
         size_t getSize() {return size;};
-        Node *getLeft() {return left;};
-        Node *getRight() {return right;};
-        void setLeft(Node *node) {left=node;};
-        void setRight(Node *node) {right=node;};
+        uint32_t getLeft() {return left;};
+        uint32_t getRight() {return right;};
+        void setLeft(Node *node) {left=(node == nullptr) ? 0 : node->index;};
+        void setRight(Node *node) {right=(node == nullptr) ? 0 : node->index;};
         void setSize(size_t s) {size=s;};
+
+        friend class NodePool;
     };
-    Node *root;
-public:
-    explicit OrderedSet() : root(nullptr) {};
 
-    class Iterator {
-        friend OrderedSet<type>;
+    // nodes of a set and its copies, chunk c holds indices [2^c, 2^(c+1)) and never moves, so indices and
+    // pointers stay valid, released slots are reused through a free list threaded through them
+    class NodePool {
+        static constexpr unsigned SMALL_CHUNKS = 4; // indices 1 to 15 share one allocation
+        uintptr_t bases[32] = {}; // address of chunk c minus 2^c nodes, so a lookup is one load and one add
+        uint32_t next = 1; // first never used index, 0 is null
+        std::atomic<uint32_t> freeList{0};
+    public:
+        NodePool() = default;
+        NodePool(const NodePool &) = delete;
+        ~NodePool() {
+            for (unsigned chunk = SMALL_CHUNKS - 1; chunk < 32; chunk++) {
+                if (bases[chunk] != 0) {
+                    ::operator delete(reinterpret_cast<void*>(bases[chunk] + firstOf(chunk) * sizeof(Node)));
+                }
+            }
+        }
+
+        Node *at(uint32_t index) {
+            if (index == 0) {
+                return nullptr;
+            }
+            return reinterpret_cast<Node*>(bases[chunkOf(index)] + index * sizeof(Node));
+        }
 
-        size_t i;
-        OrderedSet<type> set;
-        Node **list;
-        size_t size;
+        Node *allocate(type data, size_t key) {
+            uint32_t index = freeList.load(std::memory_order_acquire);
+            if (index != 0) {
+                uint32_t nextFree;
+                memcpy(&nextFree, at(index), sizeof(uint32_t));
+                freeList.store(nextFree, std::memory_order_relaxed);
+            } else {
+                index = next++;
+                unsigned chunk = chunkOf(index);
+                if (bases[chunk] == 0) {
+                    grow(chunk);
+                }
+            }
+            return new (at(index)) Node(data, key, index);
+        }
 
-    public:
-        explicit Iterator(OrderedSet<type> set) : i(0), set(set), size(set.getSize()) {
-            list = new Node*[set.getSize()];
-            rek(set.root);
-            i = 0;
+        // safe from the threads of a parallel set operation, allocate is not
+        void release(Node *node) {
+            uint32_t index = node->index, head = freeList.load(std::memory_order_relaxed);
+            node->~Node();
+            do {
+                memcpy(static_cast<void*>(node), &head, sizeof(uint32_t));
+            } while (!freeList.compare_exchange_weak(head, index, std::memory_order_release, std::memory_order_relaxed));
         }
-        ~Iterator() {
-            delete list;
+
+        // drops all nodes at once, only for types without destructor
+        void reset() {
+            next = 1;
+            freeList.store(0, std::memory_order_relaxed);
         }
 
-        void rek(Node *node) {
-            if (node != nullptr) {
-                rek(node->getLeft());
-                list[i] = node;
-                i++;
-                rek(node->getRight());
+    private:
+        static unsigned chunkOf(uint32_t index) {return __builtin_clz(index) ^ 31;} // compiles to a single bsr
+        static size_t firstOf(unsigned chunk) {return (chunk < SMALL_CHUNKS) ? 1 : size_t(1) << chunk;}
+
+        void grow(unsigned chunk) {
+            if (chunk < SMALL_CHUNKS) {
+                size_t count = (size_t(1) << SMALL_CHUNKS) - 1;
+                uintptr_t base = reinterpret_cast<uintptr_t>(::operator new(count * sizeof(Node))) - sizeof(Node);
+                for (unsigned c = 0; c < SMALL_CHUNKS; c++) {
+                    bases[c] = base;
+                }
+            } else {
+                size_t count = size_t(1) << chunk;
+                bases[chunk] = reinterpret_cast<uintptr_t>(::operator new(count * sizeof(Node))) - count * sizeof(Node);
+            }
+        }
+    };
+
+    // one step of the path from root to the last touched node, subtree of node holds keys between low and high
+    struct Step {
+        Node *node, *low, *high;
+    };
+
+    Node *root, *minNode, *maxNode; // min and max are cached for O(1) access
+    NodePool *pool; // shared by copies, same as the nodes
+    std::vector<Step> finger; // searches start from here, so keys close to the previous one are found quickly
+
+    // in-order walk over a tree without building a list, the stack holds one path from root, add and the joins keep
+    // nodes weight balanced and remove never makes a path longer, so with less than 2^32 nodes it has at most 63
+    class Cursor {
+        static constexpr size_t MAX_DEPTH = 64;
+        Node *stack[MAX_DEPTH];
+        size_t depth = 0;
+        NodePool *pool;
+    public:
+        explicit Cursor(OrderedSet<type, Compare, Aggregate> &set) : pool(set.pool) {pushLeft(set.root);};
+        Cursor(OrderedSet<type, Compare, Aggregate> &set, Node &probe) : pool(set.pool) { // starts at first element >= probe
+            Node *root = set.root;
+            while (root != nullptr) {
+                if (*root < probe) {
+                    root = rightOf(root);
+                } else {
+                    push(root);
+                    root = leftOf(root);
+                }
+            }
+        };
+        Cursor(OrderedSet<type, Compare, Aggregate> &set, size_t index) : pool(set.pool) { // starts at item on index
+            Node *root = set.root;
+            while (root != nullptr) {
+                size_t skipped = sizeOf(leftOf(root));
+                if (index > skipped) {
+                    index -= skipped + 1;
+                    root = rightOf(root);
+                } else {
+                    push(root);
+                    root = (index == skipped) ? nullptr : leftOf(root);
+                }
             }
         };
 
         void operator++() {
-            if (i < 0 || i >= size) {
+            if (depth == 0) {
                 throw IndexOutOfRangeException();
             }
-            i++;
+            Node *node = pop();
+            pushLeft(rightOf(node));
         };
 
-        type getData() {return list[i]->getData();}
-        bool finished() {return i < size;};
+        Node *getNode() {return stack[depth-1];};
+        bool finished() {return depth > 0;};
 
     private:
-        Node* getNode() {return list[i];}
+        Node *leftOf(Node *node) {return pool->at(node->getLeft());};
+        Node *rightOf(Node *node) {return pool->at(node->getRight());};
+        void pushLeft(Node *node) {
+            while (node != nullptr) {
+                push(node);
+                node = leftOf(node);
+            }
+        };
+        void push(Node *node) {stack[depth++] = node;};
+        Node *pop() {return stack[--depth];};
+    };
+public:
+    explicit OrderedSet() : root(nullptr), minNode(nullptr), maxNode(nullptr), pool(nullptr) {};
+
+    // bidirectional, keeps the path from root to its element, so ++ and -- are amortised O(1) and it can be placed
+    // anywhere in O(log n), finished() is false after the last element and before the first one, -- from after the
+    // last element or ++ from before the first one steps back onto the set
+    class Iterator {
+        friend OrderedSet<type, Compare, Aggregate>;
+
+        OrderedSet<type, Compare, Aggregate> set;
+        std::vector<Node*> path; // from root to the current node, empty when off the set
+        size_t index; // of the current node, getSize() after the last element, SIZE_MAX before the first one
+
+    public:
+        explicit Iterator(OrderedSet<type, Compare, Aggregate> set) : Iterator(set, 0) {};
+        Iterator(OrderedSet<type, Compare, Aggregate> set, size_t index) : set(set), index(index) {
+            if (index >= this->set.getSize()) {
+                this->index = this->set.getSize();
+                return;
+            }
+            Node *node = this->set.root;
+            while (true) {
+                path.push_back(node);
+                size_t skipped = sizeOf(this->set.leftOf(node));
+                if (index == skipped) {
+                    break;
+                }
+                if (index < skipped) {
+                    node = this->set.leftOf(node);
+                } else {
+                    index -= skipped + 1;
+                    node = this->set.rightOf(node);
+                }
+            }
+        };
+        Iterator(OrderedSet<type, Compare, Aggregate> set, Node &probe) : set(set), index(set.getSize()) { // first element >= probe
+            Node *node = this->set.root;
+            size_t before = 0, kept = 0;
+            while (node != nullptr) {
+                path.push_back(node);
+                if (*node < probe) {
+                    before += sizeOf(this->set.leftOf(node)) + 1;
+                    node = this->set.rightOf(node);
+                } else {
+                    kept = path.size();
+                    index = before + sizeOf(this->set.leftOf(node));
+                    node = (*node == probe) ? nullptr : this->set.leftOf(node);
+                }
+            }
+            path.resize(kept);
+        };
+
+        void operator++() {
+            if (index == set.getSize()) {
+                throw IndexOutOfRangeException();
+            }
+            index++;
+            step(path.empty() ? nullptr : path.back(), false);
+        };
+        void operator--() {
+            if (index == SIZE_MAX) {
+                throw IndexOutOfRangeException();
+            }
+            index--;
+            step(path.empty() ? nullptr : path.back(), true);
+        };
+
+        type getData() {return path.back()->getData();}
+        size_t getIndex() {return index;}
+        bool finished() {return !path.empty();};
+
+    private:
+        Node* getNode() {return path.back();}
+
+        // to the next node (previous one if back), from outside of the set to the first (last) one
+        void step(Node *node, bool back) {
+            Node *child = (node == nullptr) ? set.root : set.childOf(node, back);
+            if (child != nullptr) {
+                for (; child != nullptr; child = set.childOf(child, !back)) {
+                    path.push_back(child);
+                }
+                return;
+            }
+            if (node == nullptr) { // empty set
+                return;
+            }
+            do { // up while coming from the side we are moving to
+                child = path.back();
+                path.pop_back();
+            } while (!path.empty() && set.childOf(path.back(), back) == child);
+        };
     };
 
     friend Iterator;
     Iterator getIterator() {
         return Iterator(*this);
     }
-
-    OrderedSet<type> setUnion(OrderedSet<type> otherSet) {
-        OrderedSet<type> newSet {otherSet};
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            newSet.add(iter.getData());
+    // iterators placed in O(log n), on the last element, on the element with index (after the last one if index is
+    // getSize()) and on the first element >= value
+    Iterator getReverseIterator() {
+        Iterator iter(*this, getSize());
+        --iter;
+        return iter;
+    }
+    Iterator getIteratorAt(size_t index) {
+        if (index > getSize()) {
+            throw IndexOutOfRangeException();
         }
+        return Iterator(*this, index);
+    }
+    Iterator getIteratorFrom(type value) {return getIteratorFrom(value, keyOf(value));}
+    Iterator getIteratorFrom(type value, int key) {
+        Node probe(value, key);
+        return Iterator(*this, probe);
+    }
+
+    OrderedSet<type, Compare, Aggregate> setUnion(OrderedSet<type, Compare, Aggregate> otherSet) {
+        OrderedSet<type, Compare, Aggregate> newSet;
+        newSet.root = newSet.copyTree(*this);
+        newSet.unionWith(otherSet);
         return newSet;
     };
 
-    OrderedSet<type> setIntersection(OrderedSet<type> otherSet) {
-        OrderedSet<type> newSet;
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            if (otherSet.contains(iter.getData())) {
-                newSet.add(iter.getData());
-            }
-        }
+    OrderedSet<type, Compare, Aggregate> setIntersection(OrderedSet<type, Compare, Aggregate> otherSet) {
+        OrderedSet<type, Compare, Aggregate> newSet;
+        newSet.root = newSet.copyTree(*this);
+        newSet.intersectWith(otherSet);
         return newSet;
     };
 
-    bool operator==(OrderedSet<type> otherSet) {
-        if (getSize() != otherSet.getSize()) {
-            return false;
-        }
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            if (!otherSet.contains(iter.getData())) {
-                return false;
-            }
-        }
-        return true;
+    OrderedSet<type, Compare, Aggregate> setDifference(OrderedSet<type, Compare, Aggregate> otherSet) {
+        OrderedSet<type, Compare, Aggregate> newSet;
+        newSet.root = newSet.copyTree(*this);
+        newSet.differenceWith(otherSet);
+        return newSet;
     };
-    bool operator<(OrderedSet<type> otherSet) {
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            if (!otherSet.contains(iter.getData())) {
-                return false;
-            }
-        }
-        if (getSize() >= otherSet.getSize()) {
-            return false;
-        }
-        return true;
+
+    // in-place variants, only otherSet is copied, the rest is O(m log(n/m + 1)) split/join work
+    void unionWith(OrderedSet<type, Compare, Aggregate> otherSet) {
+        root = unionRek(root, copyTree(otherSet), forkBudget());
+        refreshEnds();
+        finger.clear();
+    };
+    void intersectWith(OrderedSet<type, Compare, Aggregate> otherSet) {
+        root = intersectionRek(root, copyTree(otherSet), forkBudget());
+        refreshEnds();
+        finger.clear();
+    };
+    void differenceWith(OrderedSet<type, Compare, Aggregate> otherSet) {
+        root = differenceRek(root, copyTree(otherSet), forkBudget());
+        refreshEnds();
+        finger.clear();
     };
-    bool operator>(OrderedSet<type> otherSet) {return otherSet < *this;};
-    bool operator<=(OrderedSet<type> otherSet) {return *this < otherSet || *this == otherSet;};
-    bool operator>=(OrderedSet<type> otherSet) {return *this > otherSet || *this == otherSet;};
 
+    bool operator==(OrderedSet<type, Compare, Aggregate> otherSet) {return getSize() == otherSet.getSize() && isSubset(otherSet);};
+    bool operator<(OrderedSet<type, Compare, Aggregate> otherSet) {return getSize() < otherSet.getSize() && isSubset(otherSet);};
+    bool operator>(OrderedSet<type, Compare, Aggregate> otherSet) {return otherSet < *this;};
+    bool operator<=(OrderedSet<type, Compare, Aggregate> otherSet) {return getSize() <= otherSet.getSize() && isSubset(otherSet);};
+    bool operator>=(OrderedSet<type, Compare, Aggregate> otherSet) {return otherSet <= *this;};
+
+    // O(1) for types without destructor, other nodes have to be destroyed one by one
     void clear() {
-        Node *n = nullptr;
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            delete n;
-            n = iter.getNode();
+        if constexpr (std::is_trivially_destructible<Node>::value) {
+            if (pool != nullptr) {
+                pool->reset();
+            }
+        } else {
+            deleteTree(root);
         }
-        delete n;
-        root = nullptr;
+        root = minNode = maxNode = nullptr;
+        finger.clear();
+    };
+    // clear that also frees the NodePool, copies share it, so none of them can be used afterwards
+    void destroy() {
+        clear();
+        delete pool;
+        pool = nullptr;
     };
 
     template<typename... types>
     void addMultiple(type value, types... values) {add(value); addMultiple(values...);};
-    void add(type value) { add(value, hash(value)); };
+    void add(type value) { add(value, keyOf(value)); };
     void add(type value, int key) {
-        if (!contains(value, key)) {
-            Node *newNode = new Node(value, key);
-            addToList(newNode);
+        Node probe(value, key);
+        if (seek(probe) == nullptr) {
+            addToList(newNode(value, key));
+        }
+    };
+
+    // adds a batch in one pass, balanced tree of the batch is joined into the set in O(m log(n/m + 1)),
+    // the batch should be sorted in the order of the set, otherwise it gets sorted first
+    template<typename Input>
+    void addSortedRun(Input begin, Input end) {
+        std::vector<Node*> nodes;
+        bool sorted = true;
+        for (; begin != end; ++begin) {
+            type value = *begin;
+            nodes.push_back(newNode(value, keyOf(value)));
+            sorted = sorted && (nodes.size() == 1 || !(*nodes.back() < *nodes[nodes.size() - 2]));
         }
+        if (!sorted) {
+            std::stable_sort(nodes.begin(), nodes.end(), [](Node *a, Node *b) {return *a < *b;});
+        }
+        size_t unique = 0;
+        for (Node *node : nodes) {
+            if (unique > 0 && *nodes[unique - 1] == *node) {
+                deleteNode(node);
+            } else {
+                nodes[unique++] = node;
+            }
+        }
+        root = unionRek(linkTree(nodes.data(), 0, unique), root, forkBudget()); // nodes already in the set win
+        refreshEnds();
+        finger.clear();
     };
 
-    void remove(type value) { remove(value, hash(value)); };
-    void remove(type value, int key) {  // REFACTOR: this looks too complicated
+    void remove(type value) { remove(value, keyOf(value)); };
+    void remove(type value, int key) {
         if (!contains(value, key)) {
             throw ValueNotFoundException();
         }
-        Node *node = root, *n = nullptr, *nodeToRemove = new Node(value, key);
-        while (node != nullptr) {
+        Node *node = root, *n = nullptr, nodeToRemove(value, key);
+        while (!(*node == nodeToRemove)) {
+            --(*node);
+            n = node;
+            node = childOf(node, nodeToRemove < *node);
+        }
+        unlink(n, node);
+        updateAggregates(nodeToRemove);
+    };
+
+    type popMin() {
+        if (root == nullptr) {
+            throw EmptySetException();
+        }
+        Node *node = root, *n = nullptr;
+        while (leftOf(node) != nullptr) {
             --(*node);
-            if (*node == *nodeToRemove) {
-                Node* newSubtree;
-                if (node->getLeft() == nullptr && node->getRight() == nullptr) {
-                    newSubtree = nullptr;
-                } else if (node->getLeft() == nullptr) {
-                    newSubtree = node->getRight();
-                } else if (node->getRight() == nullptr) {
-                    newSubtree = node->getLeft();
-                } else {
-                    if (node->getLeft()->getSize() < node->getRight()->getSize()) {
-                        getMax(node->getLeft(), node->getRight()->getSize())->setRight(node->getRight());;
-                        newSubtree = node->getLeft();
-                    } else {
-                        getMin(node->getRight(), node->getRight()->getSize())->setLeft(node->getLeft());
-                        newSubtree = node->getRight();
-                    }
-                }
-                if (n == nullptr) {
-                    root = newSubtree;
-                } else if (n->getLeft() == node) {
-                    n->setLeft(newSubtree);
-                } else {
-                    n->setRight(newSubtree);
-                }
-                delete node;
-                delete nodeToRemove;
-                return;
-            }
             n = node;
-            if (*nodeToRemove < *node) {
-                node = node->getLeft();
+            node = leftOf(node);
+        }
+        Node *right = rightOf(node);
+        if (n == nullptr) {
+            root = right;
+        } else {
+            n->setLeft(right);
+        }
+        minNode = (right == nullptr) ? n : leftmost(right);
+        if (root == nullptr) {
+            maxNode = nullptr;
+        }
+        updateAggregates(*node);
+        finger.clear();
+        type data = node->getData();
+        deleteNode(node);
+        return data;
+    };
+
+    type popMax() {
+        if (root == nullptr) {
+            throw EmptySetException();
+        }
+        Node *node = root, *n = nullptr;
+        while (rightOf(node) != nullptr) {
+            --(*node);
+            n = node;
+            node = rightOf(node);
+        }
+        Node *left = leftOf(node);
+        if (n == nullptr) {
+            root = left;
+        } else {
+            n->setRight(left);
+        }
+        maxNode = (left == nullptr) ? n : rightmost(left);
+        if (root == nullptr) {
+            minNode = nullptr;
+        }
+        updateAggregates(*node);
+        finger.clear();
+        type data = node->getData();
+        deleteNode(node);
+        return data;
+    };
+
+    type removeAt(size_t index) {
+        if (index >= getSize()) {
+            throw IndexOutOfRangeException();
+        }
+        Node *node = root, *n = nullptr;
+        size_t skipped = sizeOf(leftOf(node));
+        while (index != skipped) {
+            --(*node);
+            n = node;
+            if (index < skipped) {
+                node = leftOf(node);
             } else {
-                node = node->getRight();
+                index -= skipped + 1;
+                node = rightOf(node);
             }
+            skipped = sizeOf(leftOf(node));
         }
-        delete nodeToRemove;
-        throw ValueNotFoundException();
+        type data = node->getData();
+        Node probe(data, node->getKey());
+        unlink(n, node);
+        updateAggregates(probe);
+        return data;
     };
 
-    bool contains(type value) { return contains(value, hash(value)); };
+    bool contains(type value) { return contains(value, keyOf(value)); };
     bool contains(type value, int key) {
-        Node *node = root, *nodeToFind = new Node(value, key);
+        Node *node = root, nodeToFind(value, key);
         while (node != nullptr) {
-            if (*node == *nodeToFind) {
-                delete nodeToFind;
+            if (*node == nodeToFind) {
                 return true;
             }
-            if (*nodeToFind < *node) {
-                node = node->getLeft();
-            } else {
-                node = node->getRight();
-            }
+            node = childOf(node, nodeToFind < *node);
         }
-        delete nodeToFind;
         return false;
     };
 
     size_t getSize() {return (root == nullptr) ? 0 : root->getSize();}
     type min() {
-        if (root == nullptr) {
+        if (minNode == nullptr) {
             throw EmptySetException();
         }
-        Node *node = root;
-        while (node->getLeft() != nullptr) {
-            node = node->getLeft();
-        }
-        return node->getData();
+        return minNode->getData();
     };
     type max() {
-        if (root == nullptr) {
+        if (maxNode == nullptr) {
             throw EmptySetException();
         }
-        Node *node = root;
-        while (node->getRight() != nullptr) {
-            node = node->getRight();
-        }
-        return node->getData();
+        return maxNode->getData();
     };
+    // big sets are filled by several threads, each one writes its own range of the list
     type *getSortedList() {
         type *listToReturn = new type[getSize()];
-        int j = 0;
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            listToReturn[j] = iter.getData();
-            j++;
-        }
+        fill(ArrayView<type>(listToReturn, getSize()));
         return listToReturn;
     };
+    // getSortedList into a buffer of the caller, same threads, returns the number of elements written,
+    // IndexOutOfRangeException if buffer is smaller than the set
+    size_t fill(ArrayView<type> buffer) {
+        if (buffer.getSize() < getSize()) {
+            throw IndexOutOfRangeException();
+        }
+        type *out = buffer.getData();
+        walkInParallel([&](size_t i, Node *node) {out[i] = node->getData();});
+        return getSize();
+    };
+    // writes every element to out in sorted order on the calling thread, returns out after the last one
+    template<typename Output>
+    Output copyTo(Output out) {
+        for (Cursor cursor(*this); cursor.finished(); ++cursor) {
+            *out++ = cursor.getNode()->getData();
+        }
+        return out;
+    };
+
+    // calls f for every element, for big sets from several threads at once, each thread goes through
+    // its own range of elements in sorted order, so f has to be thread safe
+    template<typename Function>
+    void forEach(Function f) {
+        walkInParallel([&](size_t, Node *node) {f(node->getData());});
+    };
+
+    // calls f for every element starting with prefix in sorted order, requires a lexicographic Compare
+    template<typename Function>
+    void forEachWithPrefix(type prefix, Function f) {
+        static_assert(!HASH_ORDERED, "prefix ranges require OrderedSet ordered by value");
+        Node probe(prefix, 0);
+        for (Cursor cursor(*this, probe); cursor.finished(); ++cursor) {
+            type data = cursor.getNode()->getData();
+            if (!hasPrefix(data, prefix)) {
+                return;
+            }
+            f(data);
+        }
+    };
+
+    Summary getAggregate() {return summaryOf(root);};
+    // aggregate of all elements between from and to (both included), in sorted order
+    Summary getAggregate(type from, type to) {return getAggregate(from, keyOf(from), to, keyOf(to));};
+    Summary getAggregate(type from, int fromKey, type to, int toKey) {
+        Node lo(from, fromKey), hi(to, toKey), *node = root;
+        while (node != nullptr) {
+            if (*node < lo) {
+                node = rightOf(node);
+            } else if (hi < *node) {
+                node = leftOf(node);
+            } else {
+                break;
+            }
+        }
+        if (node == nullptr) {
+            return Aggregate::identity();
+        }
+        Summary result = Aggregate::identity();
+        for (Node *n = leftOf(node); n != nullptr;) { // suffix of left subtree, elements >= lo
+            if (*n < lo) {
+                n = rightOf(n);
+            } else {
+                result = Aggregate::combine(Aggregate::combine(Aggregate::of(n->getData()), summaryOf(rightOf(n))), result);
+                n = leftOf(n);
+            }
+        }
+        result = Aggregate::combine(result, Aggregate::of(node->getData()));
+        for (Node *n = rightOf(node); n != nullptr;) { // prefix of right subtree, elements <= hi
+            if (hi < *n) {
+                n = leftOf(n);
+            } else {
+                result = Aggregate::combine(result, Aggregate::combine(summaryOf(leftOf(n)), Aggregate::of(n->getData())));
+                n = rightOf(n);
+            }
+        }
+        return result;
+    };
 
     type getItem(size_t index) {
         if (root == nullptr) {
             throw EmptySetException();
         }
         int skipped = 0;
-        if (root->getLeft() != nullptr) {
-            skipped = root->getLeft()->getSize();
+        if (leftOf(root) != nullptr) {
+            skipped = leftOf(root)->getSize();
         }
         return getItemRek(skipped, root, index);
     };
-    size_t getIndex(type value) {return getIndex(value, hash(value));}
+    size_t getIndex(type value) {return getIndex(value, keyOf(value));}
     size_t getIndex(type value, int key) {
-        Node *nodeToFind = new Node(value, key);
-        size_t i = getIndexRek(0, root, nodeToFind);
-        delete nodeToFind;
-        return i;
+        Node nodeToFind(value, key);
+        return getIndexRek(0, root, &nodeToFind);
+    };
+
+    // found[i] tells whether values[i] is in the set, descents of several values are interleaved, so their cache
+    // misses overlap instead of waiting for each other
+    void containsBatch(type *values, size_t count, bool *found) {
+        descendBatch<false>(values, count, [&](size_t i, Node *node, size_t) {found[i] = node != nullptr;});
+    };
+    // indexes[i] is getIndex(values[i]), throws after the whole batch is done if some value is not in the set
+    void getIndexBatch(type *values, size_t count, size_t *indexes) {
+        bool missing = false;
+        descendBatch<true>(values, count, [&](size_t i, Node *node, size_t index) {
+            indexes[i] = index;
+            missing |= node == nullptr;
+        });
+        if (missing) {
+            throw ValueNotFoundException();
+        }
     };
 
 private:
 
     void addMultiple() {};
 
+    // sets ordered by Compare do not need hashes, key is unused there
+    size_t keyOf(type &value) {
+        if constexpr (HASH_ORDERED) {
+            return hash(value);
+        } else {
+            return 0;
+        }
+    };
+
+    static bool hasPrefix(const std::string &value, const std::string &prefix) {
+        return value.compare(0, prefix.size(), prefix) == 0;
+    };
+    static bool hasPrefix(const char *value, const char *prefix) {
+        return strncmp(value, prefix, strlen(prefix)) == 0;
+    };
+
     template <typename Integer,
             std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
     size_t hash(Integer &key) { return key; };
@@ -286,68 +771,512 @@ private:
         return h;
     };
 
+    Node *leftOf(Node *node) {return pool->at(node->getLeft());}
+    Node *rightOf(Node *node) {return pool->at(node->getRight());}
+    // picks the index before translating it, so the compiler can select it without a branch
+    Node *childOf(Node *node, bool left) {return pool->at(left ? node->getLeft() : node->getRight());}
+
+    Node *newNode(type data, size_t key) {
+        if (pool == nullptr) {
+            pool = new NodePool();
+        }
+        return pool->allocate(data, key);
+    }
+
+    void deleteNode(Node *node) {
+        if (node != nullptr) {
+            pool->release(node);
+        }
+    }
+
+    // climbs from the last touched node until its subtree can hold probe and descends from there, which is
+    // O(log d) steps for a key d positions away, finger ends on the found node or on the parent of probe
+    Node *seek(Node &probe) {
+        finger.resize(deepestHolding(probe));
+        Step step = {root, nullptr, nullptr};
+        if (!finger.empty()) {
+            step = finger.back();
+            finger.pop_back();
+        }
+        while (step.node != nullptr) {
+            finger.push_back(step);
+            Node *node = step.node;
+            if (*node == probe) {
+                return node;
+            }
+            if (probe < *node) {
+                step = {leftOf(node), step.low, node};
+            } else {
+                step = {rightOf(node), node, step.high};
+            }
+        }
+        return nullptr;
+    }
+
+    // number of steps of finger whose subtree can hold probe, those form a prefix of it, so galloping up from
+    // the end and binary search keep this at O(log d) comparisons
+    size_t deepestHolding(Node &probe) {
+        size_t holding = finger.size(), jump = 1; // steps [0, lo) hold probe, steps [hi, size) do not
+        while (holding > 0 && !holds(finger[holding - 1], probe)) {
+            holding = (holding > jump) ? holding - jump : 0;
+            jump *= 2;
+        }
+        size_t lo = holding, hi = std::min(finger.size(), holding + jump / 2);
+        while (lo + 1 < hi) {
+            size_t middle = lo + (hi - lo) / 2;
+            if (holds(finger[middle - 1], probe)) {
+                lo = middle;
+            } else {
+                hi = middle;
+            }
+        }
+        return lo;
+    }
+
+    static bool holds(Step &step, Node &probe) {
+        return (step.low == nullptr || *step.low < probe) && (step.high == nullptr || probe < *step.high);
+    }
+
+    // hangs nodeToAdd under the end of finger (left by seek) and restores weight balance bottom up,
+    // only sizes are touched while the path stays balanced, rotations cut the finger above them
     void addToList(Node *nodeToAdd) {
         if (root == nullptr) {
-            root = nodeToAdd;
+            root = minNode = maxNode = nodeToAdd;
+            finger.push_back({nodeToAdd, nullptr, nullptr});
             return;
         }
-        Node *node = root;
-        while (node != nodeToAdd) {
+        if (*nodeToAdd < *minNode) {
+            minNode = nodeToAdd;
+        }
+        if (*maxNode < *nodeToAdd) {
+            maxNode = nodeToAdd;
+        }
+        Step parent = finger.back();
+        if (*nodeToAdd < *parent.node) {
+            parent.node->setLeft(nodeToAdd);
+            finger.push_back({nodeToAdd, parent.low, parent.node});
+        } else {
+            parent.node->setRight(nodeToAdd);
+            finger.push_back({nodeToAdd, parent.node, parent.high});
+        }
+        Node *child = nodeToAdd;
+        for (size_t level = finger.size() - 1; level-- > 0;) {
+            Node *node = finger[level].node, *subtree = node;
             ++(*node);
-            if (*nodeToAdd < *node) {
-                if (node->getLeft() == nullptr) {
-                    node->setLeft(nodeToAdd);
-                    return;
-                }
-                node = node->getLeft();
-            } else {
-                if (node->getRight() == nullptr) {
-                    node->setRight(nodeToAdd);
-                    return;
+            if (!like(weight(child), node->getSize() - sizeOf(child))) {
+                subtree = join(leftOf(node), node, rightOf(node));
+            } else if (AGGREGATED) {
+                link(leftOf(node), node, rightOf(node));
+            }
+            if (subtree != node) {
+                finger.resize(level);
+                Node *parent = (level == 0) ? nullptr : finger[level - 1].node;
+                if (parent == nullptr) {
+                    root = subtree;
+                } else if (leftOf(parent) == node) {
+                    parent->setLeft(subtree);
+                } else {
+                    parent->setRight(subtree);
                 }
-                node = node->getRight();
             }
+            child = subtree;
         }
-        throw SomethingWentBadException(); // this should not happen
     };
 
-    Node *getMin(Node* node, size_t sizeToAdd) {
-        while(node->getLeft() != nullptr) {
-            node->setSize(node->getSize()+sizeToAdd);
-            node = node->getLeft();
+    // replaces node (child of n, or root) by join of its subtrees, sizes above it have to be updated already
+    void unlink(Node *n, Node *node) {
+        Node *newSubtree = join2(leftOf(node), rightOf(node));
+        if (n == nullptr) {
+            root = newSubtree;
+        } else if (leftOf(n) == node) {
+            n->setLeft(newSubtree);
+        } else {
+            n->setRight(newSubtree);
+        }
+        if (node == minNode || node == maxNode) {
+            refreshEnds();
+        }
+        finger.clear();
+        deleteNode(node);
+    }
+
+    // recomputes aggregates on the path from root towards target bottom up, after target was added or removed
+    void updateAggregates(Node &target) {
+        if (AGGREGATED) {
+            pullPath(root, target);
+        }
+    }
+
+    void pullPath(Node *node, Node &target) {
+        if (node == nullptr || *node == target) {
+            return;
+        }
+        pullPath((target < *node) ? leftOf(node) : rightOf(node), target);
+        link(leftOf(node), node, rightOf(node));
+    }
+
+    void refreshEnds() {
+        minNode = (root == nullptr) ? nullptr : leftmost(root);
+        maxNode = (root == nullptr) ? nullptr : rightmost(root);
+    }
+
+    Node *leftmost(Node *node) {
+        while (leftOf(node) != nullptr) {
+            node = leftOf(node);
         }
         return node;
     }
 
-    Node *getMax(Node* node, size_t sizeToAdd) {
-        while(node->getRight() != nullptr) {
-            node->setSize(node->getSize()+sizeToAdd);
-            node = node->getRight();
+    Node *rightmost(Node *node) {
+        while (rightOf(node) != nullptr) {
+            node = rightOf(node);
         }
         return node;
     }
 
+    // one simultaneous in-order walk over both trees, stops on first element missing in otherSet
+    bool isSubset(OrderedSet<type, Compare, Aggregate> &otherSet) {
+        Cursor mine(*this), theirs(otherSet);
+        for (; mine.finished(); ++mine) {
+            while (theirs.finished() && *theirs.getNode() < *mine.getNode()) {
+                ++theirs;
+            }
+            if (!theirs.finished() || !(*theirs.getNode() == *mine.getNode())) {
+                return false;
+            }
+            ++theirs;
+        }
+        return true;
+    }
+
+    static size_t sizeOf(Node *node) {return (node == nullptr) ? 0 : node->getSize();}
+    static size_t weight(Node *node) {return sizeOf(node) + 1;}
+    static Summary summaryOf(Node *node) {return (node == nullptr) ? Aggregate::identity() : node->getSummary();}
+    static bool like(size_t w1, size_t w2) { // alpha <= w1 / (w1 + w2) <= 1 - alpha
+        return BALANCE_PERCENT * (w1 + w2) <= 100 * w1 && 100 * w1 <= (100 - BALANCE_PERCENT) * (w1 + w2);
+    }
+
+    // splits the sorted order into equal index ranges, subtree sizes let every thread start its cursor
+    // directly at its first index, so the split is even for any shape of the tree
+    template<typename Visit>
+    void walkInParallel(Visit visit) {
+        size_t size = getSize(), parts = std::max<size_t>(1, std::min<size_t>(forkBudget(), size / PARALLEL_GRAIN));
+        auto walk = [&](size_t part) {
+            size_t from = size * part / parts, to = size * (part + 1) / parts;
+            Cursor cursor(*this, from);
+            for (size_t i = from; i < to; i++, ++cursor) {
+                visit(i, cursor.getNode());
+            }
+        };
+        std::vector<std::future<void>> futures;
+        for (size_t part = 1; part < parts; part++) {
+            futures.push_back(std::async(std::launch::async, walk, part));
+        }
+        walk(0);
+        for (auto &future : futures) {
+            future.get();
+        }
+    }
+
+    static Node *link(Node *left, Node *node, Node *right) {
+        node->setLeft(left);
+        node->setRight(right);
+        node->setSize(sizeOf(left) + sizeOf(right) + 1);
+        if (AGGREGATED) {
+            node->setSummary(Aggregate::combine(Aggregate::combine(summaryOf(left), Aggregate::of(node->getData())),
+                                                summaryOf(right)));
+        }
+        return node;
+    }
+
+    Node *rotateLeft(Node *node) {
+        Node *r = rightOf(node);
+        link(leftOf(node), node, leftOf(r));
+        return link(node, r, rightOf(r));
+    }
+
+    Node *rotateRight(Node *node) {
+        Node *l = leftOf(node);
+        link(rightOf(l), node, rightOf(node));
+        return link(leftOf(l), l, node);
+    }
+
+    // join -> every key in left < node < every key in right, result is weight balanced if left and right are
+    Node *join(Node *left, Node *node, Node *right) {
+        if (weight(left) > weight(right)) {
+            return joinRight(left, node, right);
+        }
+        if (weight(right) > weight(left)) {
+            return joinLeft(left, node, right);
+        }
+        return link(left, node, right);
+    }
+
+    Node *joinRight(Node *left, Node *node, Node *right) {
+        if (left == nullptr || weight(left) <= weight(right) || like(weight(left), weight(right))) {
+            return link(left, node, right);
+        }
+        Node *t = joinRight(rightOf(left), node, right), *l = leftOf(left);
+        if (like(weight(l), weight(t))) {
+            return link(l, left, t);
+        }
+        if (leftOf(t) != nullptr && !(like(weight(l), weight(leftOf(t))) &&
+                                         like(weight(l) + weight(leftOf(t)), weight(rightOf(t))))) {
+            t = rotateRight(t);
+        }
+        return rotateLeft(link(l, left, t));
+    }
+
+    Node *joinLeft(Node *left, Node *node, Node *right) {
+        if (right == nullptr || weight(right) <= weight(left) || like(weight(right), weight(left))) {
+            return link(left, node, right);
+        }
+        Node *t = joinLeft(left, node, leftOf(right)), *r = rightOf(right);
+        if (like(weight(r), weight(t))) {
+            return link(t, right, r);
+        }
+        if (rightOf(t) != nullptr && !(like(weight(r), weight(rightOf(t))) &&
+                                          like(weight(r) + weight(rightOf(t)), weight(leftOf(t))))) {
+            t = rotateLeft(t);
+        }
+        return rotateRight(link(t, right, r));
+    }
+
+    // join without middle node -> every key in left < every key in right
+    Node *join2(Node *left, Node *right) {
+        if (left == nullptr) {
+            return right;
+        }
+        Node *last = nullptr;
+        Node *rest = splitLast(left, last);
+        return join(rest, last, right);
+    }
+
+    Node *splitLast(Node *node, Node *&last) {
+        if (rightOf(node) == nullptr) {
+            last = node;
+            return leftOf(node);
+        }
+        Node *rest = splitLast(rightOf(node), last);
+        return join(leftOf(node), node, rest);
+    }
+
+    // splits tree into keys smaller and bigger than probe, returns detached node with equal key or nullptr
+    Node *split(Node *node, Node &probe, Node *&left, Node *&right) {
+        if (node == nullptr) {
+            left = right = nullptr;
+            return nullptr;
+        }
+        Node *l = leftOf(node), *r = rightOf(node);
+        if (*node == probe) {
+            left = l;
+            right = r;
+            return node;
+        }
+        Node *found;
+        if (probe < *node) {
+            found = split(l, probe, left, right);
+            right = join(right, node, r);
+        } else {
+            found = split(r, probe, left, right);
+            left = join(l, node, left);
+        }
+        return found;
+    }
+
+    static unsigned forkBudget() {
+        unsigned threads = std::thread::hardware_concurrency();
+        return (threads == 0) ? 1 : threads;
+    }
+
+    // runs both halves of a set operation, in parallel if it is big enough and we have threads left
+    template<typename Left, typename Right>
+    static void fork(size_t work, unsigned forks, Left left, Right right) {
+        if (forks > 1 && work > PARALLEL_GRAIN) {
+            auto future = std::async(std::launch::async, left);
+            right();
+            future.get();
+        } else {
+            left();
+            right();
+        }
+    }
+
+    Node *unionRek(Node *a, Node *b, unsigned forks) {
+        if (a == nullptr) {
+            return b;
+        }
+        if (b == nullptr) {
+            return a;
+        }
+        size_t work = a->getSize() + b->getSize();
+        Node *aLeft = leftOf(a), *aRight = rightOf(a), *bLeft, *bRight, *left, *right;
+        Node *found = split(b, *a, bLeft, bRight);
+        if (found != nullptr) { // values from otherSet win, same as adding into a copy of it
+            deleteNode(a);
+            a = found;
+        }
+        fork(work, forks,
+             [&] {left = unionRek(aLeft, bLeft, forks/2);},
+             [&] {right = unionRek(aRight, bRight, forks - forks/2);});
+        return join(left, a, right);
+    }
+
+    Node *intersectionRek(Node *a, Node *b, unsigned forks) {
+        if (a == nullptr || b == nullptr) {
+            deleteTree(a);
+            deleteTree(b);
+            return nullptr;
+        }
+        size_t work = a->getSize() + b->getSize();
+        Node *aLeft = leftOf(a), *aRight = rightOf(a), *bLeft, *bRight, *left, *right;
+        Node *found = split(b, *a, bLeft, bRight);
+        fork(work, forks,
+             [&] {left = intersectionRek(aLeft, bLeft, forks/2);},
+             [&] {right = intersectionRek(aRight, bRight, forks - forks/2);});
+        if (found == nullptr) {
+            deleteNode(a);
+            return join2(left, right);
+        }
+        deleteNode(found);
+        return join(left, a, right);
+    }
+
+    Node *differenceRek(Node *a, Node *b, unsigned forks) {
+        if (a == nullptr || b == nullptr) {
+            deleteTree(b);
+            return a;
+        }
+        size_t work = a->getSize() + b->getSize();
+        Node *bLeft = leftOf(b), *bRight = rightOf(b), *aLeft, *aRight, *left, *right;
+        Node *found = split(a, *b, aLeft, aRight);
+        deleteNode(found);
+        deleteNode(b);
+        fork(work, forks,
+             [&] {left = differenceRek(aLeft, bLeft, forks/2);},
+             [&] {right = differenceRek(aRight, bRight, forks - forks/2);});
+        return join2(left, right);
+    }
+
+    void deleteTree(Node *node) {
+        if (node != nullptr) {
+            deleteTree(leftOf(node));
+            deleteTree(rightOf(node));
+            deleteNode(node);
+        }
+    }
+
+    // balanced copy of all nodes of set
+    Node *copyTree(OrderedSet<type, Compare, Aggregate> &set) {
+        std::vector<Node*> nodes;
+        nodes.reserve(set.getSize());
+        for (Cursor cursor(set); cursor.finished(); ++cursor) {
+            nodes.push_back(cursor.getNode());
+        }
+        return buildTree(nodes.data(), 0, nodes.size());
+    }
+
+    Node *buildTree(Node **nodes, size_t from, size_t to) {
+        if (from >= to) {
+            return nullptr;
+        }
+        size_t middle = from + (to - from) / 2;
+        Node *node = newNode(nodes[middle]->getData(), nodes[middle]->getKey());
+        return link(buildTree(nodes, from, middle), node, buildTree(nodes, middle + 1, to));
+    }
+
+    // balanced tree out of sorted nodes, without copying them
+    static Node *linkTree(Node **nodes, size_t from, size_t to) {
+        if (from >= to) {
+            return nullptr;
+        }
+        size_t middle = from + (to - from) / 2;
+        return link(linkTree(nodes, from, middle), nodes[middle], linkTree(nodes, middle + 1, to));
+    }
+
     type getItemRek(size_t i, Node *node, size_t index) {
         if (i == index) {
             return node->getData();
         }
-        if (node->getLeft() != nullptr && i > index) {
+        if (leftOf(node) != nullptr && i > index) {
             int skipped = 0;
-            if (node->getLeft()->getRight() != nullptr) {
-                skipped = node->getLeft()->getRight()->getSize();
+            if (rightOf(leftOf(node)) != nullptr) {
+                skipped = rightOf(leftOf(node))->getSize();
             }
-            return getItemRek(i-1-skipped, node->getLeft(), index);
+            return getItemRek(i-1-skipped, leftOf(node), index);
         }
-        if (node->getRight() != nullptr) {
+        if (rightOf(node) != nullptr) {
             int skipped = 0;
-            if (node->getRight()->getLeft() != nullptr) {
-                skipped = node->getRight()->getLeft()->getSize();
+            if (leftOf(rightOf(node)) != nullptr) {
+                skipped = leftOf(rightOf(node))->getSize();
             }
-            return getItemRek(i+1+skipped, node->getRight(), index);
+            return getItemRek(i+1+skipped, rightOf(node), index);
         }
         throw IndexOutOfRangeException();
     }
 
+    // one descent of a batch, passed is the size of the node turned right from, node itself and its left subtree
+    // are before the value, which is passed minus size of the right child, known once that child is loaded
+    struct Lane {
+        size_t at, key, index, passed;
+        Node *node, *found;
+    };
+
+    // asynchronous memory access chaining: every lane makes one step of its descent and prefetches the node of its
+    // next step, which is loaded while the other lanes work, a finished lane takes the next value of the batch,
+    // finish gets the position in the batch, the node found (or nullptr) and its index in sorted order if RANKED
+    template<bool RANKED, typename Finish>
+    void descendBatch(type *values, size_t count, Finish &&finish) {
+        Lane lanes[BATCH_LANES];
+        size_t started = 0, active = 0;
+        auto start = [&](Lane &lane) {
+            int key = keyOf(values[started]); // keys go through int like in add and contains
+            lane = {started, size_t(key), 0, 0, root, nullptr};
+            started++;
+        };
+        while (active < BATCH_LANES && started < count) {
+            start(lanes[active++]);
+        }
+        while (active > 0) {
+            for (size_t l = 0; l < active;) {
+                Lane &lane = lanes[l];
+                Node *node = lane.node;
+                if constexpr (RANKED) {
+                    if (lane.passed != 0) {
+                        lane.index += lane.passed - sizeOf(node);
+                        lane.passed = 0;
+                    }
+                }
+                if (node == nullptr || lane.found != nullptr) { // descent ended, the lane is reused without moving on
+                    finish(lane.at, lane.found, lane.index);
+                    if (started < count) {
+                        start(lane);
+                    } else {
+                        lane = lanes[--active];
+                    }
+                    continue;
+                }
+                if (node->same(values[lane.at], lane.key)) {
+                    lane.found = node;
+                    lane.node = nullptr;
+                    if constexpr (RANKED) { // one more step to the right child counts the left subtree
+                        lane.node = rightOf(node);
+                        lane.passed = node->getSize() - 1;
+                        __builtin_prefetch(lane.node);
+                    }
+                } else {
+                    bool left = node->after(values[lane.at], lane.key);
+                    lane.node = childOf(node, left);
+                    __builtin_prefetch(lane.node);
+                    if constexpr (RANKED) {
+                        lane.passed = left ? 0 : node->getSize();
+                    }
+                }
+                l++;
+            }
+        }
+    }
+
     size_t getIndexRek(size_t i, Node *node, Node *nodeToFind) {
         if (node == nullptr) {
             throw EmptySetException();
@@ -355,18 +1284,18 @@ private:
         int skipped;
         if (*node == *nodeToFind) {
             skipped = 0;
-            if (node->getLeft() != nullptr) {
-                skipped = node->getLeft()->getSize();
+            if (leftOf(node) != nullptr) {
+                skipped = leftOf(node)->getSize();
             }
             return i+skipped;
         }
         if (*nodeToFind < *node) {
-            return getIndexRek(i, node->getLeft(), nodeToFind);
+            return getIndexRek(i, leftOf(node), nodeToFind);
         }
         skipped = 0;
-        if (node->getLeft() != nullptr) {
-            skipped = node->getLeft()->getSize();
+        if (leftOf(node) != nullptr) {
+            skipped = leftOf(node)->getSize();
         }
-        return getIndexRek(i+skipped+1, node->getRight(), nodeToFind);
+        return getIndexRek(i+skipped+1, rightOf(node), nodeToFind);
     }
 };
\ No newline at end of file
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <future>
+#include "Exceptions.h"
+
+// same elements as CombinedSet (different types are not equal even with the same key), but every type has its own
+// table, values of one type lie in one array, so typed scans touch nothing else and set operations go type by type
+template<class... types> class PartitionedCombinedSet {
+    static constexpr size_t typeArraySize = sizeof...(types);
+    static constexpr size_t PARALLEL_GRAIN = 4096; // smaller tables are combined on the calling thread
+
+    // values and keys are dense arrays, slots are an open addressing index over them (linear probing, position + 1,
+    // 0 is empty), removing moves the last element into the hole, so the arrays stay without gaps
+    template<typename T> class Table {
+        std::vector<T> values;
+        std::vector<size_t> keys;
+        std::vector<uint32_t> slots;
+        unsigned shift; // home slot is the top bits of key * golden ratio, slots.size() is 2^(64 - shift)
+    public:
+        Table() : slots(8, 0), shift(61) {};
+
+        bool add(const T &value, size_t key) {
+            size_t slot = locate(key);
+            if (slots[slot] != 0) {
+                return false;
+            }
+            values.push_back(value);
+            keys.push_back(key);
+            slots[slot] = values.size();
+            if (values.size() * 4 > slots.size() * 3) {
+                grow();
+            }
+            return true;
+        };
+        bool remove(size_t key) {
+            size_t slot = locate(key);
+            if (slots[slot] == 0) {
+                return false;
+            }
+            size_t position = slots[slot] - 1, last = values.size() - 1;
+            if (position != last) {
+                slots[locate(keys[last])] = position + 1;
+                values[position] = std::move(values[last]);
+                keys[position] = keys[last];
+            }
+            values.pop_back();
+            keys.pop_back();
+            size_t mask = slots.size() - 1, hole = slot; // shift back the slots that probed past the hole
+            for (size_t next = (hole + 1) & mask; slots[next] != 0; next = (next + 1) & mask) {
+                if (((next - home(keys[slots[next] - 1])) & mask) >= ((next - hole) & mask)) {
+                    slots[hole] = slots[next];
+                    hole = next;
+                }
+            }
+            slots[hole] = 0;
+            return true;
+        };
+        bool contains(size_t key) {return slots[locate(key)] != 0;};
+        void clear() {
+            values.clear();
+            keys.clear();
+            std::fill(slots.begin(), slots.end(), 0);
+        };
+
+        size_t getSize() {return values.size();};
+        T &getData(size_t i) {return values[i];};
+        size_t getKey(size_t i) {return keys[i];};
+
+        // this = a | b or a & b
+        void combine(Table<T> &a, Table<T> &b, bool unite) {
+            if (unite) {
+                *this = a;
+                for (size_t i = 0; i < b.getSize(); i++) {
+                    add(b.values[i], b.keys[i]);
+                }
+                return;
+            }
+            Table<T> &smaller = (a.getSize() <= b.getSize()) ? a : b, &bigger = (&smaller == &a) ? b : a;
+            for (size_t i = 0; i < smaller.getSize(); i++) {
+                if (bigger.contains(smaller.keys[i])) {
+                    add(smaller.values[i], smaller.keys[i]);
+                }
+            }
+        };
+
+    private:
+        size_t home(size_t key) {return (key * 0x9E3779B97F4A7C15ull) >> shift;};
+
+        // slot holding key, or the empty one where it would go
+        size_t locate(size_t key) {
+            size_t mask = slots.size() - 1, slot = home(key);
+            while (slots[slot] != 0 && keys[slots[slot] - 1] != key) {
+                slot = (slot + 1) & mask;
+            }
+            return slot;
+        };
+
+        void grow() {
+            shift--;
+            slots.assign(slots.size() * 2, 0);
+            size_t mask = slots.size() - 1;
+            for (size_t i = 0; i < keys.size(); i++) {
+                size_t slot = home(keys[i]);
+                while (slots[slot] != 0) {
+                    slot = (slot + 1) & mask;
+                }
+                slots[slot] = i + 1;
+            }
+        };
+    };
+
+    std::tuple<Table<types>...> tables;
+public:
+    explicit PartitionedCombinedSet() {};
+
+    // walks the values of one type only, in the order of its array
+    template<typename type> class Iterator {
+        friend PartitionedCombinedSet<types...>;
+
+        Table<type> *table;
+        size_t i;
+    public:
+        explicit Iterator(Table<type> *table) : table(table), i(0) {};
+
+        void operator++() {
+            if (i >= table->getSize()) {
+                throw IndexOutOfRangeException();
+            }
+            i++;
+        };
+
+        type getData() {return table->getData(i);}
+        bool finished() {return i < table->getSize();};
+    };
+
+    template<typename type>
+    Iterator<type> getIterator() {
+        return Iterator<type>(tableOf<type>());
+    }
+
+    // calls f with every element of type
+    template<typename type, typename Function>
+    void forEach(Function &&f) {
+        Table<type> *table = tableOf<type>();
+        for (size_t i = 0; i < table->getSize(); i++) {
+            f(table->getData(i));
+        }
+    };
+    // calls f with every element as its own type, type by type, f has to accept all of them
+    template<typename Function>
+    void forEach(Function &&f) {
+        std::apply([&](auto &... table) {(walk(table, f), ...);}, tables);
+    };
+
+    // type by type, types with big tables are combined on their own threads
+    PartitionedCombinedSet<types...> setUnion(PartitionedCombinedSet<types...> otherSet) {
+        PartitionedCombinedSet<types...> newSet;
+        newSet.combine(*this, otherSet, true, std::index_sequence_for<types...>());
+        return newSet;
+    };
+    PartitionedCombinedSet<types...> setIntersection(PartitionedCombinedSet<types...> otherSet) {
+        PartitionedCombinedSet<types...> newSet;
+        newSet.combine(*this, otherSet, false, std::index_sequence_for<types...>());
+        return newSet;
+    };
+
+    bool operator==(PartitionedCombinedSet<types...> otherSet) {return getSize() == otherSet.getSize() && isSubset(otherSet);};
+    bool operator<(PartitionedCombinedSet<types...> otherSet) {return getSize() < otherSet.getSize() && isSubset(otherSet);};
+    bool operator>(PartitionedCombinedSet<types...> otherSet) {return otherSet < *this;};
+    bool operator<=(PartitionedCombinedSet<types...> otherSet) {return getSize() <= otherSet.getSize() && isSubset(otherSet);};
+    bool operator>=(PartitionedCombinedSet<types...> otherSet) {return otherSet <= *this;};
+
+    void clear() {
+        std::apply([](auto &... table) {(table.clear(), ...);}, tables);
+    };
+
+    template<typename type, typename... otherTypes>
+    void addMultiple(type value, otherTypes... values) {add(value); addMultiple(values...);};
+    template<typename type>
+    void add(type value) { add<type>(value, hash(value)); };
+    template<typename type>
+    void add(type value, int key) {
+        tableOf<type>()->add(value, key);
+    };
+
+    template<typename type>
+    void remove(type value) { remove(value, hash(value)); };
+    template<typename type>
+    void remove(type value, int key) {
+        if (!tableOf<type>()->remove(key)) {
+            throw ValueNotFoundException();
+        }
+    };
+
+    template<typename type>
+    bool contains(type value) { return contains(value, hash(value)); };
+    template<typename type>
+    bool contains(type value, int key) {
+        return tableOf<type>()->contains(key);
+    };
+
+    size_t getSize() {
+        return std::apply([](auto &... table) {return (size_t(0) + ... + table.getSize());}, tables);
+    }
+    // O(1), elements of one type
+    template<typename type>
+    size_t getSize() {return tableOf<type>()->getSize();}
+
+private:
+
+    void addMultiple() {};
+
+    template <typename Integer,
+            std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+    size_t hash(Integer &key) { return key; };
+    template <typename Floating,
+            std::enable_if_t<std::is_floating_point<Floating>::value, bool> = true>
+    size_t hash(Floating &key) {
+        size_t result = 0;
+        memcpy(&result, &key, sizeof( double ));
+        return result ^ (result >> 32); // keys are ints, so the exponent has to reach the low half
+    };
+    size_t hash(const char* key) {
+        unsigned h = 0;
+        while (*key) {
+            h = h * 101 + (unsigned) *key++;
+        }
+        return h;
+    };
+    size_t hash(const std::string key) {
+        unsigned h = 0;
+        const char *a = key.c_str();
+        while (*a) {
+            h = h * 101 + (unsigned) *a++;
+        }
+        return h;
+    };
+
+    // position of type in types, typeArraySize if the set does not accept it
+    template<typename typeToFind>
+    static constexpr size_t indexOf() {
+        constexpr bool matches[] = {std::is_same<typeToFind, types>::value...};
+        for (size_t i = 0; i < typeArraySize; i++) {
+            if (matches[i]) {
+                return i;
+            }
+        }
+        return typeArraySize;
+    };
+
+    template<typename type>
+    Table<type> *tableOf() {
+        if constexpr (indexOf<type>() == typeArraySize) {
+            throw TypeNotAcceptedException();
+        } else {
+            return &std::get<indexOf<type>()>(tables);
+        }
+    };
+
+    template<typename T, typename Function>
+    static void walk(Table<T> &table, Function &f) {
+        for (size_t i = 0; i < table.getSize(); i++) {
+            f(table.getData(i));
+        }
+    };
+
+    template<size_t... I>
+    void combine(PartitionedCombinedSet<types...> &a, PartitionedCombinedSet<types...> &b, bool unite, std::index_sequence<I...>) {
+        std::vector<std::future<void>> jobs;
+        auto run = [&](auto &result, auto &tableA, auto &tableB) {
+            if (typeArraySize > 1 && tableA.getSize() + tableB.getSize() > PARALLEL_GRAIN) {
+                jobs.push_back(std::async(std::launch::async, [unite](auto *result, auto *a, auto *b) {
+                    result->combine(*a, *b, unite);
+                }, &result, &tableA, &tableB));
+            } else {
+                result.combine(tableA, tableB, unite);
+            }
+        };
+        (run(std::get<I>(tables), std::get<I>(a.tables), std::get<I>(b.tables)), ...);
+        for (auto &job : jobs) {
+            job.get();
+        }
+    };
+
+    bool isSubset(PartitionedCombinedSet<types...> &otherSet) {
+        return isSubset(otherSet, std::index_sequence_for<types...>());
+    };
+    template<size_t... I>
+    bool isSubset(PartitionedCombinedSet<types...> &otherSet, std::index_sequence<I...>) {
+        auto within = [](auto &mine, auto &theirs) {
+            for (size_t i = 0; i < mine.getSize(); i++) {
+                if (!theirs.contains(mine.getKey(i))) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        return (within(std::get<I>(tables), std::get<I>(otherSet.tables)) && ...);
+    };
+};
\ No newline at end of file
@@ -0,0 +1,419 @@
+#pragma once
+
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <atomic>
+#include <vector>
+#include "Exceptions.h"
+#include "OrderedSet.h"
+
+// immutable ordered set, add and remove return a new version that shares all nodes off the changed path,
+// copies are O(1) snapshots and can be read from other threads while new versions are built
+template<class type, class Compare = HashOrder> class PersistentOrderedSet {
+    static constexpr bool HASH_ORDERED = std::is_same<Compare, HashOrder>::value;
+    static constexpr size_t BALANCE_PERCENT = 29; // weight balance parameter alpha (in %), same as OrderedSet
+
+    // nodes never change after construction, refs counts versions and parent nodes pointing at it
+    class Node {
+        type data;
+        size_t key, size;
+        Node *left, *right;
+        std::atomic<size_t> refs;
+    public:
+        Node(type data, size_t key) : data(data), key(key), size(1), left(nullptr), right(nullptr), refs(1) {};
+        Node(Node *left, Node &node, Node *right) : data(node.data), key(node.key),
+                size(sizeOf(left) + sizeOf(right) + 1), left(retain(left)), right(retain(right)), refs(1) {};
+        bool operator==(Node &node) {
+            if constexpr (HASH_ORDERED) {
+                return key == node.key;
+            } else {
+                return !Compare()(data, node.data) && !Compare()(node.data, data);
+            }
+        };
+        bool operator<(Node &node) {
+            if constexpr (HASH_ORDERED) {
+                return key < node.key;
+            } else {
+                return Compare()(data, node.data);
+            }
+        };
+        type getData() {return data;};
+        size_t getKey() {return key;};
+        size_t getSize() {return size;};
+        Node *getLeft() {return left;};
+        Node *getRight() {return right;};
+
+        friend PersistentOrderedSet<type, Compare>;
+    };
+    Node *root;
+
+    explicit PersistentOrderedSet(Node *root) : root(root) {}; // takes over the reference of root
+public:
+    explicit PersistentOrderedSet() : root(nullptr) {};
+    // sortedList has to be sorted in the order of the set (same as getSortedList of OrderedSet)
+    explicit PersistentOrderedSet(type *sortedList, size_t size) : root(buildTree(sortedList, 0, size)) {};
+    // snapshot of the current content of set
+    template<class Aggregate>
+    explicit PersistentOrderedSet(OrderedSet<type, Compare, Aggregate> set) : root(nullptr) {
+        type *list = set.getSortedList();
+        *this = PersistentOrderedSet<type, Compare>(list, set.getSize());
+        delete[] list;
+    };
+    PersistentOrderedSet(const PersistentOrderedSet<type, Compare> &set) : root(retain(set.root)) {};
+    PersistentOrderedSet<type, Compare> &operator=(const PersistentOrderedSet<type, Compare> &set) {
+        Node *old = root;
+        root = retain(set.root);
+        release(old);
+        return *this;
+    };
+    ~PersistentOrderedSet() {
+        release(root);
+    };
+
+    // in-order walk, holds its own snapshot so the version it walks stays alive
+    class Iterator {
+        friend PersistentOrderedSet<type, Compare>;
+
+        PersistentOrderedSet<type, Compare> set;
+        std::vector<Node*> stack;
+    public:
+        explicit Iterator(PersistentOrderedSet<type, Compare> set) : set(set) {
+            pushLeft(set.root);
+        }
+
+        void operator++() {
+            if (stack.empty()) {
+                throw IndexOutOfRangeException();
+            }
+            Node *node = stack.back();
+            stack.pop_back();
+            pushLeft(node->getRight());
+        };
+
+        type getData() {return stack.back()->getData();}
+        bool finished() {return !stack.empty();};
+
+    private:
+        void pushLeft(Node *node) {
+            for (; node != nullptr; node = node->getLeft()) {
+                stack.push_back(node);
+            }
+        }
+    };
+
+    friend Iterator;
+    Iterator getIterator() {
+        return Iterator(*this);
+    }
+
+    template<typename... types>
+    PersistentOrderedSet<type, Compare> addMultiple(type value, types... values) {
+        return add(value).addMultiple(values...);
+    };
+    PersistentOrderedSet<type, Compare> add(type value) {return add(value, keyOf(value));};
+    PersistentOrderedSet<type, Compare> add(type value, int key) {
+        if (contains(value, key)) {
+            return *this;
+        }
+        Node node(value, key), *left, *right;
+        split(root, node, left, right);
+        Node *newRoot = join(left, node, right);
+        release(left);
+        release(right);
+        return PersistentOrderedSet<type, Compare>(newRoot);
+    };
+
+    PersistentOrderedSet<type, Compare> remove(type value) {return remove(value, keyOf(value));};
+    PersistentOrderedSet<type, Compare> remove(type value, int key) {
+        Node node(value, key), *left, *right;
+        if (!split(root, node, left, right)) {
+            release(left);
+            release(right);
+            throw ValueNotFoundException();
+        }
+        Node *newRoot = join2(left, right);
+        release(left);
+        release(right);
+        return PersistentOrderedSet<type, Compare>(newRoot);
+    };
+
+    bool contains(type value) {return contains(value, keyOf(value));};
+    bool contains(type value, int key) {
+        Node nodeToFind(value, key);
+        Node *node = root;
+        while (node != nullptr) {
+            if (*node == nodeToFind) {
+                return true;
+            }
+            node = (nodeToFind < *node) ? node->getLeft() : node->getRight();
+        }
+        return false;
+    };
+
+    size_t getSize() {return sizeOf(root);}
+    type min() {
+        if (root == nullptr) {
+            throw EmptySetException();
+        }
+        Node *node = root;
+        while (node->getLeft() != nullptr) {
+            node = node->getLeft();
+        }
+        return node->getData();
+    };
+    type max() {
+        if (root == nullptr) {
+            throw EmptySetException();
+        }
+        Node *node = root;
+        while (node->getRight() != nullptr) {
+            node = node->getRight();
+        }
+        return node->getData();
+    };
+    type *getSortedList() {
+        type *listToReturn = new type[getSize()];
+        int j = 0;
+        for (auto iter = getIterator(); iter.finished(); ++iter) {
+            listToReturn[j] = iter.getData();
+            j++;
+        }
+        return listToReturn;
+    };
+
+    type getItem(size_t index) {
+        Node *node = root;
+        while (node != nullptr) {
+            size_t left = sizeOf(node->getLeft());
+            if (index == left) {
+                return node->getData();
+            }
+            if (index < left) {
+                node = node->getLeft();
+            } else {
+                index -= left + 1;
+                node = node->getRight();
+            }
+        }
+        throw IndexOutOfRangeException();
+    };
+    size_t getIndex(type value) {return getIndex(value, keyOf(value));}
+    size_t getIndex(type value, int key) {
+        Node nodeToFind(value, key);
+        Node *node = root;
+        size_t index = 0;
+        while (node != nullptr) {
+            if (*node == nodeToFind) {
+                return index + sizeOf(node->getLeft());
+            }
+            if (nodeToFind < *node) {
+                node = node->getLeft();
+            } else {
+                index += sizeOf(node->getLeft()) + 1;
+                node = node->getRight();
+            }
+        }
+        throw ValueNotFoundException();
+    };
+
+private:
+
+    PersistentOrderedSet<type, Compare> addMultiple() {return *this;};
+
+    static Node *retain(Node *node) {
+        if (node != nullptr) {
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return node;
+    }
+
+    // last reference frees the node and drops its references to children
+    static void release(Node *node) {
+        while (node != nullptr && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Node *left = node->left, *right = node->right;
+            delete node;
+            release(left);
+            node = right;
+        }
+    }
+
+    // all tree helpers below borrow their arguments and return a new reference
+
+    static size_t sizeOf(Node *node) {return (node == nullptr) ? 0 : node->getSize();}
+    static size_t weight(Node *node) {return sizeOf(node) + 1;}
+    static bool like(size_t w1, size_t w2) { // alpha <= w1 / (w1 + w2) <= 1 - alpha
+        return BALANCE_PERCENT * (w1 + w2) <= 100 * w1 && 100 * w1 <= (100 - BALANCE_PERCENT) * (w1 + w2);
+    }
+
+    // copy of node with new children
+    static Node *link(Node *left, Node &node, Node *right) {
+        return new Node(left, node, right);
+    }
+
+    // link that consumes the references of owned children
+    static Node *linkOwned(Node *left, Node &node, Node *right, Node *owned, Node *alsoOwned = nullptr) {
+        Node *result = link(left, node, right);
+        release(owned);
+        release(alsoOwned);
+        return result;
+    }
+
+    static Node *rotateLeft(Node *node) {
+        Node *r = node->getRight();
+        Node *left = link(node->getLeft(), *node, r->getLeft());
+        return linkOwned(left, *r, r->getRight(), left);
+    }
+
+    static Node *rotateRight(Node *node) {
+        Node *l = node->getLeft();
+        Node *right = link(l->getRight(), *node, node->getRight());
+        return linkOwned(l->getLeft(), *l, right, right);
+    }
+
+    // join -> every key in left < node < every key in right, result is weight balanced if left and right are
+    static Node *join(Node *left, Node &node, Node *right) {
+        if (weight(left) > weight(right)) {
+            return joinRight(left, node, right);
+        }
+        if (weight(right) > weight(left)) {
+            return joinLeft(left, node, right);
+        }
+        return link(left, node, right);
+    }
+
+    static Node *joinRight(Node *left, Node &node, Node *right) {
+        if (left == nullptr || weight(left) <= weight(right) || like(weight(left), weight(right))) {
+            return link(left, node, right);
+        }
+        Node *t = joinRight(left->getRight(), node, right), *l = left->getLeft();
+        if (like(weight(l), weight(t))) {
+            return linkOwned(l, *left, t, t);
+        }
+        if (t->getLeft() != nullptr && !(like(weight(l), weight(t->getLeft())) &&
+                                         like(weight(l) + weight(t->getLeft()), weight(t->getRight())))) {
+            Node *rotated = rotateRight(t);
+            release(t);
+            t = rotated;
+        }
+        Node *linked = linkOwned(l, *left, t, t), *result = rotateLeft(linked);
+        release(linked);
+        return result;
+    }
+
+    static Node *joinLeft(Node *left, Node &node, Node *right) {
+        if (right == nullptr || weight(right) <= weight(left) || like(weight(right), weight(left))) {
+            return link(left, node, right);
+        }
+        Node *t = joinLeft(left, node, right->getLeft()), *r = right->getRight();
+        if (like(weight(r), weight(t))) {
+            return linkOwned(t, *right, r, t);
+        }
+        if (t->getRight() != nullptr && !(like(weight(r), weight(t->getRight())) &&
+                                          like(weight(r) + weight(t->getRight()), weight(t->getLeft())))) {
+            Node *rotated = rotateLeft(t);
+            release(t);
+            t = rotated;
+        }
+        Node *linked = linkOwned(t, *right, r, t), *result = rotateRight(linked);
+        release(linked);
+        return result;
+    }
+
+    // join without middle node -> every key in left < every key in right
+    static Node *join2(Node *left, Node *right) {
+        if (left == nullptr) {
+            return retain(right);
+        }
+        Node *last = nullptr;
+        Node *rest = splitLast(left, last);
+        Node *result = join(rest, *last, right);
+        release(rest);
+        return result;
+    }
+
+    // last is borrowed from the tree of node
+    static Node *splitLast(Node *node, Node *&last) {
+        if (node->getRight() == nullptr) {
+            last = node;
+            return retain(node->getLeft());
+        }
+        Node *rest = splitLast(node->getRight(), last);
+        Node *result = join(node->getLeft(), *node, rest);
+        release(rest);
+        return result;
+    }
+
+    // new trees with keys smaller and bigger than probe, returns if a node with equal key was left out
+    static bool split(Node *node, Node &probe, Node *&left, Node *&right) {
+        if (node == nullptr) {
+            left = right = nullptr;
+            return false;
+        }
+        Node *l = node->getLeft(), *r = node->getRight();
+        if (*node == probe) {
+            left = retain(l);
+            right = retain(r);
+            return true;
+        }
+        bool found;
+        if (probe < *node) {
+            found = split(l, probe, left, right);
+            Node *joined = join(right, *node, r);
+            release(right);
+            right = joined;
+        } else {
+            found = split(r, probe, left, right);
+            Node *joined = join(l, *node, left);
+            release(left);
+            left = joined;
+        }
+        return found;
+    }
+
+    Node *buildTree(type *sortedList, size_t from, size_t to) {
+        if (from >= to) {
+            return nullptr;
+        }
+        size_t middle = from + (to - from) / 2;
+        Node node(sortedList[middle], int(keyOf(sortedList[middle]))); // keys go through int, as in add
+        Node *left = buildTree(sortedList, from, middle), *right = buildTree(sortedList, middle + 1, to);
+        return linkOwned(left, node, right, left, right);
+    }
+
+    size_t keyOf(type &value) {
+        if constexpr (HASH_ORDERED) {
+            return hash(value);
+        } else {
+            return 0;
+        }
+    };
+
+    template <typename Integer,
+            std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+    size_t hash(Integer &key) { return key; };
+    template <typename Floating,
+            std::enable_if_t<std::is_floating_point<Floating>::value, bool> = true>
+    size_t hash(Floating &key) {
+        size_t result = 0;
+        memcpy(&result, &key, sizeof(Floating));
+        return result & 0xfffff000;
+    };
+    size_t hash(const char* key) {
+        unsigned h = 0;
+        while (*key) {
+            h = h * 101 + (unsigned) *key++;
+        }
+        return h;
+    };
+    size_t hash(const std::string key) {
+        unsigned h = 0;
+        const char *a = key.c_str();
+        while (*a) {
+            h = h * 101 + (unsigned) *a++;
+        }
+        return h;
+    };
+};
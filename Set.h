@@ -6,6 +6,7 @@
 #include <stdexcept>
 #include <type_traits>
 #include "Exceptions.h"
+#include "ArrayView.h"
 
 template<class type> class Set {
     const float RESIZE_AT = 0.75;
@@ -201,13 +202,27 @@ public:
     size_t getCapacity() {return capacity;}
     type *getList() {
         type *listToReturn = new type[size];
-        int j = 0;
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            listToReturn[j] = iter.getData();
-            j++;
-        }
+        copyTo(listToReturn);
         return listToReturn;
     };
+    // writes every element to out without allocating, returns out after the last one
+    template<typename Output>
+    Output copyTo(Output out) {
+        for (size_t i = 0; i < capacity; i++) {
+            for (Node *node = list[i]; node != nullptr; node = node->getNext()) {
+                *out++ = node->getData();
+            }
+        }
+        return out;
+    };
+    // returns the number of elements written, IndexOutOfRangeException if buffer is smaller than the set
+    size_t fill(ArrayView<type> buffer) {
+        if (buffer.getSize() < size) {
+            throw IndexOutOfRangeException();
+        }
+        copyTo(buffer.getData());
+        return size;
+    };
 
 private:
 
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Exceptions.h"
+
+// owns its elements, values lie in one dense array and callers keep Handles to them, a handle is the index of a slot
+// and the generation the slot had when the value was added, removing a value bumps the generation, so handles of
+// removed values never reach a newer one, remove moves the last value into the hole to keep the array dense
+template<class type> class SlotMap {
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    struct Slot {
+        uint32_t position; // in values while used, next free slot while free
+        uint32_t generation;
+    };
+
+    std::vector<type> values;
+    std::vector<uint32_t> owners; // slot of every value, same order as values
+    std::vector<Slot> slots;
+    uint32_t firstFree = NO_SLOT;
+public:
+    class Handle {
+        friend SlotMap<type>;
+
+        uint32_t slot;
+        uint32_t generation;
+
+        Handle(uint32_t slot, uint32_t generation) : slot(slot), generation(generation) {};
+    public:
+        // refers to nothing, contains is false for it
+        Handle() : slot(NO_SLOT), generation(0) {};
+
+        bool operator==(const Handle &handle) const {return slot == handle.slot && generation == handle.generation;};
+        bool operator!=(const Handle &handle) const {return !(*this == handle);};
+    };
+
+    explicit SlotMap() {};
+
+    // walks the dense array
+    class Iterator {
+        friend SlotMap<type>;
+
+        SlotMap<type> *map;
+        size_t i;
+    public:
+        explicit Iterator(SlotMap<type> *map) : map(map), i(0) {};
+
+        void operator++() {
+            if (i >= map->values.size()) {
+                throw IndexOutOfRangeException();
+            }
+            i++;
+        };
+
+        type &getData() {
+            if (i >= map->values.size()) {
+                throw EmptySetException();
+            }
+            return map->values[i];
+        }
+        Handle getHandle() {
+            if (i >= map->values.size()) {
+                throw EmptySetException();
+            }
+            uint32_t slot = map->owners[i];
+            return Handle(slot, map->slots[slot].generation);
+        }
+        bool finished() {return i < map->values.size();};
+    };
+
+    friend Iterator;
+    Iterator getIterator() {
+        return Iterator(this);
+    }
+
+    // calls f with every value, in the order of the dense array
+    template<typename Function>
+    void forEach(Function &&f) {
+        for (auto &value : values) {
+            f(value);
+        }
+    };
+
+    void clear() {
+        for (uint32_t slot : owners) {
+            free(slot);
+        }
+        values.clear();
+        owners.clear();
+    };
+
+    Handle add(type value) {
+        uint32_t slot = firstFree;
+        if (slot == NO_SLOT) {
+            slot = slots.size();
+            slots.push_back({0, 0});
+        } else {
+            firstFree = slots[slot].position;
+        }
+        slots[slot].position = values.size();
+        values.push_back(std::move(value));
+        owners.push_back(slot);
+        return Handle(slot, slots[slot].generation);
+    };
+
+    // ValueNotFoundException for handles of removed values
+    void remove(Handle handle) {
+        uint32_t position = find(handle), last = values.size() - 1;
+        if (position != last) {
+            values[position] = std::move(values[last]);
+            owners[position] = owners[last];
+            slots[owners[position]].position = position;
+        }
+        values.pop_back();
+        owners.pop_back();
+        free(handle.slot);
+    };
+
+    bool contains(Handle handle) {
+        return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation;
+    };
+
+    type &get(Handle handle) {return values[find(handle)];};
+
+    size_t getSize() {return values.size();}
+    // valid until the next add or remove
+    type *getValues() {return values.data();}
+
+private:
+
+    uint32_t find(Handle handle) {
+        if (!contains(handle)) {
+            throw ValueNotFoundException();
+        }
+        return slots[handle.slot].position;
+    };
+
+    // handles are only made by add, so none of them has the new generation of a free slot
+    void free(uint32_t slot) {
+        slots[slot].generation++;
+        slots[slot].position = firstFree;
+        firstFree = slot;
+    };
+};
\ No newline at end of file
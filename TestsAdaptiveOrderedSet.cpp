@@ -0,0 +1,89 @@
+#include <iostream>
+#include <set>
+#include <random>
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+
+#include "AdaptiveOrderedSet.h"
+
+TEST(AdaptiveOrderedSetTest, test) {
+    AdaptiveOrderedSet<int> set;
+    set.addMultiple(5, -3, 17, 5, 0);
+    ASSERT_EQ(4, set.getSize());
+    ASSERT_FALSE(set.isTree());
+    ASSERT_TRUE(set.contains(17));
+    ASSERT_FALSE(set.contains(4));
+    ASSERT_EQ(0, set.getIndex(0));
+    ASSERT_EQ(17, set.getItem(2));
+    ASSERT_EQ(0, set.min());
+    ASSERT_EQ(-3, set.max()); // ordered by key like OrderedSet, -3 has the biggest one
+    set.remove(5);
+    int *list = set.getSortedList();
+    ASSERT_EQ(0, list[0]);
+    ASSERT_EQ(17, list[1]);
+    ASSERT_EQ(-3, list[2]);
+    delete[] list;
+    ASSERT_THROW(set.remove(5), ValueNotFoundException);
+    ASSERT_THROW(set.getIndex(5), ValueNotFoundException);
+    ASSERT_THROW(set.getItem(3), IndexOutOfRangeException);
+    set.clear();
+    ASSERT_THROW(set.min(), EmptySetException);
+}
+
+TEST(AdaptiveOrderedSetTest, switchTest) {
+    AdaptiveOrderedSet<int> set;
+    for (int i = 0; i < 64; i++) {
+        set.add(i * 2);
+    }
+    ASSERT_FALSE(set.isTree());
+    AdaptiveOrderedSet<int> small = set;
+    set.add(1);
+    ASSERT_TRUE(set.isTree());
+    ASSERT_EQ(65, set.getSize());
+    ASSERT_EQ(1, set.getIndex(1));
+    ASSERT_EQ(64, small.getSize());
+    AdaptiveOrderedSet<int> big = set;
+    for (int i = 0; i < 32; i++) {
+        set.remove(i * 2);
+    }
+    ASSERT_TRUE(set.isTree());
+    set.remove(1);
+    ASSERT_FALSE(set.isTree());
+    ASSERT_EQ(32, set.getSize());
+    int i = 32;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter, i++) {
+        ASSERT_EQ(i * 2, iter.getData());
+    }
+    ASSERT_EQ(64, i);
+    ASSERT_EQ(65, big.getSize());
+    i = 0;
+    for (auto iter = big.getIterator(); iter.finished(); ++iter, i++) {
+        ASSERT_EQ(i, big.getIndex(iter.getData()));
+    }
+    ASSERT_EQ(65, i);
+}
+
+TEST(AdaptiveOrderedSetTest, randomTest) {
+    std::mt19937 generator(11);
+    AdaptiveOrderedSet<std::string, std::less<std::string>> set;
+    std::set<std::string> reference;
+    for (int i = 0; i < 5000; i++) {
+        std::string value = std::to_string(generator() % 150);
+        if (generator() % 2 == 0) {
+            set.add(value);
+            reference.insert(value);
+        } else if (reference.count(value) > 0) {
+            set.remove(value);
+            reference.erase(value);
+        }
+        ASSERT_EQ(reference.size(), set.getSize());
+        ASSERT_EQ(reference.count(value) > 0, set.contains(value));
+    }
+    size_t index = 0;
+    for (auto &value : reference) {
+        ASSERT_EQ(value, set.getItem(index));
+        ASSERT_EQ(index, set.getIndex(value));
+        index++;
+    }
+}
\ No newline at end of file
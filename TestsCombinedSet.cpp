@@ -262,4 +262,121 @@ TEST(CombinedSetTest, clearTest) {
     for (auto iter = set.getIterator(); iter.finished(); ++iter) {
         ASSERT_TRUE(false);
     }
+}
+
+TEST(CombinedSetTest, RemoveFromChainTest) {
+    CombinedSet<int, char> set(4);
+    set.addMultiple(1, 5, 9, 'a');
+    set.remove(9); // newest entry of the bucket of 1 and 5
+    ASSERT_TRUE(set.contains(1));
+    ASSERT_TRUE(set.contains(5));
+    ASSERT_FALSE(set.contains(9));
+    set.remove(1);
+    ASSERT_TRUE(set.contains(5));
+    ASSERT_EQ(2, set.getSize());
+    ASSERT_TRUE(set.contains('a'));
+    ASSERT_FALSE(set.contains((char) 5));
+    int count = 0;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+        count++;
+    }
+    ASSERT_EQ(2, count);
+}
+
+TEST(CombinedSetTest, ManyMixedValuesTest) {
+    CombinedSet<int, long, std::string> set;
+    for (int i = 0; i < 3000; i++) {
+        set.add(i);
+        set.add((long) i * 3);
+        set.add(std::to_string(i % 500));
+    }
+    ASSERT_EQ(6500, set.getSize());
+    for (int i = 0; i < 3000; i += 2) {
+        set.remove(i);
+    }
+    ASSERT_EQ(5000, set.getSize());
+    ASSERT_FALSE(set.contains(2));
+    ASSERT_TRUE(set.contains(3));
+    ASSERT_TRUE(set.contains(6L));
+    ASSERT_TRUE(set.contains(std::string("499")));
+    ASSERT_FALSE(set.contains(std::string("500")));
+
+    CombinedSet<int, long, std::string> other;
+    other.addMultiple(1, 2, std::string("x"));
+    CombinedSet<int, long, std::string> both = set.setUnion(other);
+    ASSERT_EQ(5002, both.getSize());
+    ASSERT_EQ(3, other.getSize());
+    ASSERT_TRUE(both.contains(2));
+    ASSERT_FALSE(set.contains(2));
+}
+
+TEST(CombinedSetTest, ManyTypesTest) {
+    CombinedSet<char, short, int, long, float, double, bool, unsigned, std::string, char *> set;
+    set.addMultiple('a', (short) 97, 97, 97L, std::string("a"), true);
+    ASSERT_EQ(6, set.getSize());
+    ASSERT_TRUE(set.contains(97L));
+    ASSERT_FALSE(set.contains(97u));
+    set.remove(std::string("a"));
+    ASSERT_FALSE(set.contains(std::string("a")));
+    ASSERT_TRUE(set.contains('a'));
+    ASSERT_THROW(set.contains(97LL), TypeNotAcceptedException);
+}
+
+TEST(CombinedSetTest, VisitTest) {
+    CombinedSet<int, char, std::string> set;
+    set.addMultiple(1, 2, 'a', std::string("xyz"));
+    int ints = 0, chars = 0;
+    size_t letters = 0;
+    struct Counter {
+        int &ints, &chars;
+        size_t &letters;
+        void operator()(int value) {ints += value;}
+        void operator()(char) {chars++;}
+        void operator()(std::string &value) {letters += value.size();}
+    };
+    set.forEach(Counter{ints, chars, letters});
+    ASSERT_EQ(3, ints);
+    ASSERT_EQ(1, chars);
+    ASSERT_EQ(3, letters);
+
+    int visited = 0;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+        iter.visit([&](auto &) {visited++;});
+        if (int *value = iter.tryGet<int>()) {
+            ASSERT_TRUE(*value == 1 || *value == 2);
+            ASSERT_EQ(nullptr, iter.tryGet<char>());
+        } else if (std::string *value = iter.tryGet<std::string>()) {
+            ASSERT_EQ("xyz", *value);
+        } else {
+            ASSERT_EQ('a', *iter.tryGet<char>());
+        }
+        ASSERT_EQ(nullptr, iter.tryGet<double>());
+    }
+    ASSERT_EQ(4, visited);
+
+    CombinedSet<int, char> empty;
+    ASSERT_EQ(nullptr, empty.getIterator().tryGet<int>());
+    ASSERT_THROW(empty.getIterator().visit([](auto) {}), EmptySetException);
+}
+
+TEST(CombinedSetTest, SameKeyOtherTypeTest) {
+    CombinedSet<int, long, double> set(4);
+    for (int i = 0; i < 100; i++) {
+        set.add(i);
+        set.add(long(i));
+    }
+    set.addMultiple(1.0, 2.5, -1.0);
+    ASSERT_EQ(203, set.getSize());
+    ASSERT_TRUE(set.contains(2.5));
+    ASSERT_FALSE(set.contains(3.5));
+    for (int i = 0; i < 100; i += 2) {
+        set.remove(long(i));
+    }
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(set.contains(i));
+        ASSERT_EQ(i % 2 == 1, set.contains(long(i)));
+    }
+    set.remove(1.0);
+    ASSERT_TRUE(set.contains(-1.0));
+    ASSERT_EQ(152, set.getSize());
 }
\ No newline at end of file
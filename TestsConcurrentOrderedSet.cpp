@@ -0,0 +1,133 @@
+#include <iostream>
+#include <thread>
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+
+#include "ConcurrentOrderedSet.h"
+
+TEST(ConcurrentOrderedSetTest, test) {
+    ConcurrentOrderedSet<int> set;
+    set.add(2);
+    set.add(1);
+    set.add(2);
+    ASSERT_EQ(2, set.getSize());
+    ASSERT_TRUE(set.contains(1));
+    ASSERT_TRUE(set.contains(2));
+    ASSERT_FALSE(set.contains(3));
+    ASSERT_EQ(1, set.min());
+    set.remove(1);
+    ASSERT_FALSE(set.contains(1));
+    ASSERT_EQ(2, set.min());
+    try {
+        set.remove(1);
+        ASSERT_TRUE(false);
+    } catch (ValueNotFoundException &e) {
+        std::string a = "Value not found!";
+        ASSERT_EQ(a, e.what());
+    }
+    set.remove(2);
+    try {
+        set.min();
+        ASSERT_TRUE(false);
+    } catch (EmptySetException &e) {
+        std::string a = "Set is empty!";
+        ASSERT_EQ(a, e.what());
+    }
+}
+
+TEST(ConcurrentOrderedSetTest, IteratorTest) {
+    ConcurrentOrderedSet<int> set;
+    int a[7] = {4, 2, 6, 1, 3, 5, 7};
+    for (int i = 0; i < 7; i++) {
+        set.add(a[i]);
+    }
+    int i = 1;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter, i++) {
+        ASSERT_EQ(i, iter.getData());
+    }
+    ASSERT_EQ(8, i);
+    i = 3;
+    for (auto iter = set.getRangeIterator(3, 5); iter.finished(); ++iter, i++) {
+        ASSERT_EQ(i, iter.getData());
+    }
+    ASSERT_EQ(6, i);
+    ASSERT_EQ(0, set.getApproximateIndex(1));
+    ASSERT_LE(1, set.getApproximateIndex(100)); // estimate from skip list levels
+    ASSERT_GE(7, set.getApproximateIndex(100));
+}
+
+TEST(ConcurrentOrderedSetTest, parallelAddRemoveTest) {
+    ConcurrentOrderedSet<int> set;
+    const int threads = 4, perThread = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&set, t] {
+            for (int i = 0; i < perThread; i++) {
+                set.add(i * threads + t);
+            }
+            for (int i = 0; i < perThread; i += 2) {
+                set.remove(i * threads + t);
+            }
+        });
+    }
+    workers.emplace_back([&set] { // reads while others write
+        for (int round = 0; round < 20; round++) {
+            int last = -1;
+            for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+                ASSERT_LT(last, iter.getData());
+                last = iter.getData();
+            }
+        }
+    });
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    ASSERT_EQ(threads * perThread / 2, set.getSize());
+    int count = 0;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter, count++) {
+        ASSERT_EQ(1, (iter.getData() / threads) % 2);
+    }
+    ASSERT_EQ(threads * perThread / 2, count);
+}
+
+TEST(ConcurrentOrderedSetTest, sameKeysTest) {
+    ConcurrentOrderedSet<int> set;
+    std::vector<std::thread> workers;
+    std::atomic<int> removed {0};
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < 2000; i++) {
+                set.add(i % 50);
+                if (set.tryRemove((i * 7) % 50)) {
+                    removed++;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    int count = 0;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+        count++;
+    }
+    ASSERT_EQ(count, set.getSize());
+}
+
+TEST(ConcurrentOrderedSetTest, BigKeyRangeTest) {
+    ConcurrentOrderedSet<unsigned> set;
+    set.addMultiple(1u, 5u, 3000000000u, 3000000005u, 4000000000u); // keys above INT_MAX
+    std::vector<unsigned> found;
+    for (auto iter = set.getRangeIterator(3000000000u, 3000000005u); iter.finished(); ++iter) {
+        found.push_back(iter.getData());
+    }
+    ASSERT_EQ(2, found.size());
+    ASSERT_EQ(3000000000u, found[0]);
+    ASSERT_EQ(3000000005u, found[1]);
+    found.clear();
+    for (auto iter = set.getRangeIterator(1u, 5u); iter.finished(); ++iter) {
+        found.push_back(iter.getData());
+    }
+    ASSERT_EQ(2, found.size());
+}
\ No newline at end of file
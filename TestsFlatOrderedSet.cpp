@@ -0,0 +1,111 @@
+#include <iostream>
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+
+#include "FlatOrderedSet.h"
+
+TEST(FlatOrderedSetTest, fromOrderedSetTest) {
+    for (int n = 0; n < 40; n++) {
+        OrderedSet<int> set;
+        for (int i = 0; i < n; i++) {
+            set.add((i * 41) % n * 2);
+        }
+        FlatOrderedSet<int> flat(set);
+        ASSERT_EQ(n, flat.getSize());
+        for (int i = 0; i < n; i++) {
+            ASSERT_TRUE(flat.contains(i * 2));
+            ASSERT_FALSE(flat.contains(i * 2 + 1));
+            ASSERT_EQ(i * 2, flat.getItem(i));
+            ASSERT_EQ(i, flat.getIndex(i * 2));
+        }
+        int i = 0;
+        for (auto iter = flat.getIterator(); iter.finished(); ++iter, i++) {
+            ASSERT_EQ(i * 2, iter.getData());
+        }
+        ASSERT_EQ(n, i);
+    }
+}
+
+TEST(FlatOrderedSetTest, sortedInputTest) {
+    int a[7] = {1, 2, 3, 5, 8, 13, 21};
+    FlatOrderedSet<int> flat(a, 7);
+    ASSERT_EQ(1, flat.min());
+    ASSERT_EQ(21, flat.max());
+    ASSERT_EQ(4, flat.getIndex(8));
+    ASSERT_FALSE(flat.contains(4));
+    ASSERT_FALSE(flat.contains(22));
+    int *list = flat.getSortedList();
+    for (int i = 0; i < 7; i++) {
+        ASSERT_EQ(a[i], list[i]);
+    }
+    delete[] list;
+    try {
+        flat.getIndex(4);
+        ASSERT_TRUE(false);
+    } catch (ValueNotFoundException &e) {
+        std::string a = "Value not found!";
+        ASSERT_EQ(a, e.what());
+    }
+    try {
+        flat.getItem(7);
+        ASSERT_TRUE(false);
+    } catch (IndexOutOfRangeException &e) {
+        std::string a = "Index is out of range!";
+        ASSERT_EQ(a, e.what());
+    }
+}
+
+TEST(FlatOrderedSetTest, EmptyTest) {
+    FlatOrderedSet<int> flat(OrderedSet<int>{});
+    ASSERT_EQ(0, flat.getSize());
+    ASSERT_FALSE(flat.contains(1));
+    for (auto iter = flat.getIterator(); iter.finished(); ++iter) {
+        ASSERT_TRUE(false);
+    }
+    try {
+        flat.min();
+        ASSERT_TRUE(false);
+    } catch (EmptySetException &e) {
+        std::string a = "Set is empty!";
+        ASSERT_EQ(a, e.what());
+    }
+}
+
+TEST(FlatOrderedSetTest, stringCompareTest) {
+    OrderedSet<std::string, std::less<std::string>> set;
+    set.addMultiple(std::string("pear"), std::string("apple"), std::string("plum"), std::string("banana"));
+    FlatOrderedSet<std::string, std::less<std::string>> flat(set);
+    ASSERT_EQ("apple", flat.min());
+    ASSERT_EQ("plum", flat.max());
+    ASSERT_EQ(2, flat.getIndex("pear"));
+    ASSERT_TRUE(flat.contains("banana"));
+    ASSERT_FALSE(flat.contains("cherry"));
+
+    class A {
+    public:
+        int key = 0;
+        A(int key = 0) : key(key) {};
+    };
+    OrderedSet<A> objects;
+    A a(5), b(1), c(3);
+    objects.add(a, a.key);
+    objects.add(b, b.key);
+    objects.add(c, c.key);
+    FlatOrderedSet<A> flatObjects(objects);
+    ASSERT_TRUE(flatObjects.contains(c, c.key));
+    ASSERT_EQ(5, flatObjects.getItem(2).key);
+    ASSERT_EQ(1, flatObjects.getIndex(c, c.key));
+}
+
+TEST(FlatOrderedSetTest, BigKeyTest) {
+    OrderedSet<unsigned> source;
+    source.addMultiple(1u, 5u, 3000000000u); // key above INT_MAX
+    unsigned *sorted = source.getSortedList();
+    FlatOrderedSet<unsigned> set(sorted, 3);
+    delete[] sorted;
+    ASSERT_TRUE(set.contains(3000000000u));
+    ASSERT_EQ(source.getIndex(3000000000u), set.getIndex(3000000000u));
+    FlatOrderedSet<unsigned> copy(source);
+    ASSERT_TRUE(copy.contains(3000000000u));
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <set>
+#include <random>
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+
+#include "IntegerOrderedSet.h"
+
+TEST(IntegerOrderedSetTest, test) {
+    IntegerOrderedSet<> set;
+    set.addMultiple(70000, 5, 4294967295u, 300, 5);
+    ASSERT_EQ(4, set.getSize());
+    ASSERT_TRUE(set.contains(300));
+    ASSERT_FALSE(set.contains(301));
+    ASSERT_EQ(5, set.min());
+    ASSERT_EQ(4294967295u, set.max());
+    ASSERT_EQ(300, set.successor(5));
+    ASSERT_EQ(300, set.successor(6));
+    ASSERT_EQ(70000, set.successor(300));
+    ASSERT_EQ(70000, set.predecessor(4294967295u));
+    ASSERT_EQ(5, set.predecessor(300));
+    ASSERT_EQ(2, set.getIndex(70000));
+    ASSERT_EQ(4294967295u, set.getItem(3));
+    set.remove(70000);
+    ASSERT_EQ(4294967295u, set.successor(300));
+    unsigned *list = set.getSortedList();
+    ASSERT_EQ(5, list[0]);
+    ASSERT_EQ(300, list[1]);
+    ASSERT_EQ(4294967295u, list[2]);
+    delete[] list;
+}
+
+TEST(IntegerOrderedSetTest, randomTest) {
+    std::mt19937 generator(7);
+    for (unsigned universe : {1000u, 1u << 20, 0u}) {
+        IntegerOrderedSet<> set;
+        std::set<unsigned> reference;
+        for (int i = 0; i < 20000; i++) {
+            unsigned x = (universe == 0) ? generator() : generator() % universe;
+            if (i % 3 == 2 && reference.count(x) > 0) {
+                set.remove(x);
+                reference.erase(x);
+            } else {
+                set.add(x);
+                reference.insert(x);
+            }
+        }
+        ASSERT_EQ(reference.size(), set.getSize());
+        size_t index = 0;
+        auto iter = set.getIterator();
+        for (unsigned x : reference) {
+            ASSERT_TRUE(iter.finished());
+            ASSERT_EQ(x, iter.getData());
+            ASSERT_EQ(x, set.getItem(index));
+            ASSERT_EQ(index, set.getIndex(x));
+            ++iter;
+            index++;
+        }
+        ASSERT_FALSE(iter.finished());
+        for (int i = 0; i < 2000; i++) {
+            unsigned x = (universe == 0) ? generator() : generator() % universe;
+            auto next = reference.upper_bound(x);
+            if (next != reference.end()) {
+                ASSERT_EQ(*next, set.successor(x));
+            }
+            auto previous = reference.lower_bound(x);
+            if (previous != reference.begin()) {
+                ASSERT_EQ(*--previous, set.predecessor(x));
+            }
+            ASSERT_EQ(reference.count(x) > 0, set.contains(x));
+        }
+    }
+}
+
+TEST(IntegerOrderedSetTest, EmptyTest) {
+    IntegerOrderedSet<uint16_t> set;
+    ASSERT_FALSE(set.getIterator().finished());
+    ASSERT_FALSE(set.contains(1));
+    try {
+        set.min();
+        ASSERT_TRUE(false);
+    } catch (EmptySetException &e) {
+        std::string a = "Set is empty!";
+        ASSERT_EQ(a, e.what());
+    }
+    try {
+        set.remove(1);
+        ASSERT_TRUE(false);
+    } catch (ValueNotFoundException &e) {
+        std::string a = "Value not found!";
+        ASSERT_EQ(a, e.what());
+    }
+    set.add(65535);
+    try {
+        set.successor(65535);
+        ASSERT_TRUE(false);
+    } catch (ValueNotFoundException &e) {
+        std::string a = "Value not found!";
+        ASSERT_EQ(a, e.what());
+    }
+    IntegerOrderedSet<uint16_t> copy = set;
+    set.clear();
+    ASSERT_EQ(0, set.getSize());
+    ASSERT_EQ(1, copy.getSize());
+    ASSERT_EQ(65535, copy.max());
+}
+
+TEST(IntegerOrderedSetTest, CopyTest) {
+    IntegerOrderedSet<> set;
+    for (unsigned i = 0; i < 1000; i++) {
+        set.add(i * 4294967u); // every page
+    }
+    IntegerOrderedSet<> copy = set;
+    for (unsigned i = 0; i < 500; i++) {
+        set.remove(i * 4294967u); // empties the lower half of the pages
+    }
+    ASSERT_EQ(500, set.getSize());
+    ASSERT_EQ(1000, copy.getSize());
+    for (unsigned i = 0; i < 1000; i++) {
+        ASSERT_EQ(i >= 500, set.contains(i * 4294967u));
+        ASSERT_TRUE(copy.contains(i * 4294967u));
+        ASSERT_EQ(i, copy.getIndex(i * 4294967u));
+        ASSERT_EQ(i * 4294967u, copy.getItem(i));
+    }
+    ASSERT_EQ(4294967u * 500, set.min());
+    ASSERT_EQ(4294967u * 500, set.successor(7));
+    ASSERT_EQ(0, set.getIndex(4294967u * 500));
+    ASSERT_EQ(4294967u * 500, copy.predecessor(4294967u * 501));
+    set.clear();
+    set.add(4294967295u);
+    ASSERT_EQ(0, set.getIndex(4294967295u));
+    copy = set;
+    ASSERT_EQ(1, copy.getSize());
+    ASSERT_EQ(4294967295u, copy.min());
+}
\ No newline at end of file
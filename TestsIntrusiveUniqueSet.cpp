@@ -0,0 +1,89 @@
+#include <iostream>
+#include <set>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+
+#include "IntrusiveUniqueSet.h"
+
+struct Connection {
+    int id = 0;
+    UniqueSetHook uniqueSetHook;
+    UniqueSetHook idleHook;
+};
+
+TEST(IntrusiveUniqueSetTest, test) {
+    IntrusiveUniqueSet<Connection> set(2);
+    Connection a, b, c;
+    a.id = 1;
+    b.id = 2;
+    c.id = 3;
+    set.addMultiple(a, b, c, a);
+    ASSERT_EQ(3, set.getSize());
+    ASSERT_EQ(4, set.getCapacity());
+    ASSERT_TRUE(set.contains(b));
+    set.remove(a);
+    ASSERT_FALSE(set.contains(a));
+    ASSERT_FALSE(a.uniqueSetHook.isLinked());
+    ASSERT_THROW(set.remove(a), ValueNotFoundException);
+    int sum = 0;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+        sum += iter.getData().id;
+    }
+    ASSERT_EQ(5, sum);
+    Connection copy = b; // copies are not in the set
+    ASSERT_FALSE(set.contains(copy));
+    set.clear();
+    ASSERT_EQ(0, set.getSize());
+    ASSERT_FALSE(set.contains(b));
+    ASSERT_THROW(set.getIterator().getData(), EmptySetException);
+}
+
+TEST(IntrusiveUniqueSetTest, hooksTest) {
+    Connection a;
+    IntrusiveUniqueSet<Connection> all;
+    IntrusiveUniqueSet<Connection, &Connection::idleHook> idle;
+    all.add(a);
+    idle.add(a); // second hook, second set
+    ASSERT_TRUE(all.contains(a));
+    ASSERT_TRUE(idle.contains(a));
+    {
+        IntrusiveUniqueSet<Connection> other;
+        ASSERT_THROW(other.add(a), OccupiedSpaceException);
+        ASSERT_FALSE(other.contains(a));
+    }
+    all.remove(a);
+    {
+        IntrusiveUniqueSet<Connection> other;
+        other.add(a);
+        ASSERT_TRUE(other.contains(a));
+    } // destroyed sets unlink their objects
+    ASSERT_FALSE(a.uniqueSetHook.isLinked());
+    ASSERT_TRUE(idle.contains(a));
+}
+
+TEST(IntrusiveUniqueSetTest, randomTest) {
+    std::mt19937 generator(13);
+    std::vector<Connection> connections(400);
+    std::set<Connection *> reference;
+    IntrusiveUniqueSet<Connection> set;
+    for (int i = 0; i < 20000; i++) {
+        Connection *connection = &connections[generator() % connections.size()];
+        if (generator() % 2 == 0) {
+            set.add(*connection);
+            reference.insert(connection);
+        } else if (reference.count(connection) > 0) {
+            set.remove(*connection);
+            reference.erase(connection);
+        }
+        ASSERT_EQ(reference.size(), set.getSize());
+        ASSERT_EQ(reference.count(connection) > 0, set.contains(*connection));
+    }
+    std::set<Connection *> seen;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+        seen.insert(iter.getPointer());
+    }
+    ASSERT_TRUE(seen == reference);
+}
\ No newline at end of file
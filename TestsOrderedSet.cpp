@@ -307,4 +307,485 @@ TEST(OrderedSetTest, getIndexTest) {
     for (int i = 0; i < 6; i++) {
         ASSERT_EQ(i, set.getIndex(i+1));
     }
+}
+
+TEST(OrderedSetTest, differenceTest) {
+    OrderedSet<int> set1;
+    OrderedSet<int> set2;
+    int a1[6] = {4, 2, 6, 1, 3, 5};
+    int a2[6] = {2, 2, 8, 3, 9, 1};
+
+    for (int i = 0; i < 6; i++) {
+        set1.add(a1[i]);
+        set2.add(a2[i]);
+    }
+    OrderedSet<int> set3 = set1.setDifference(set2);
+    ASSERT_EQ(3, set3.getSize());
+    for (int i = 1; i < 11; i++) {
+        ASSERT_EQ(i >= 4 && i <= 6, set3.contains(i));
+    }
+    ASSERT_EQ(6, set1.getSize());
+    ASSERT_EQ(5, set2.getSize());
+}
+
+TEST(OrderedSetTest, bigSetOperationsTest) {
+    OrderedSet<int> set1;
+    OrderedSet<int> set2;
+    for (int i = 0; i < 20000; i++) {
+        set1.add((i * 7919) % 20000);
+    }
+    for (int i = 0; i < 3000; i++) {
+        set2.add(i * 10);
+    }
+
+    OrderedSet<int> set3 = set1.setUnion(set2);
+    ASSERT_EQ(20000 + 1000, set3.getSize());
+    for (int i = 0; i < set3.getSize(); i++) {
+        ASSERT_EQ(i, set3.getIndex(set3.getItem(i)));
+    }
+
+    OrderedSet<int> set4 = set1.setIntersection(set2);
+    ASSERT_EQ(2000, set4.getSize());
+    for (int i = 0; i < 2000; i++) {
+        ASSERT_EQ(i * 10, set4.getItem(i));
+    }
+
+    set1.differenceWith(set2);
+    ASSERT_EQ(18000, set1.getSize());
+    ASSERT_FALSE(set1.contains(10));
+    ASSERT_TRUE(set1.contains(11));
+    set1.unionWith(set2);
+    ASSERT_EQ(21000, set1.getSize());
+    ASSERT_EQ(29990, set1.max());
+}
+
+TEST(OrderedSetTest, bigConditionsTest) {
+    OrderedSet<int> set1;
+    OrderedSet<int> set2;
+    for (int i = 0; i < 1000; i++) {
+        set1.add(i);  // ascending, add rebalances it
+        set2.add((i * 7) % 1000);
+    }
+    ASSERT_TRUE(set1 == set2);
+    ASSERT_TRUE(set1 <= set2);
+    ASSERT_FALSE(set1 < set2);
+
+    set2.add(1000);
+    ASSERT_TRUE(set1 < set2);
+    ASSERT_TRUE(set2 >= set1);
+    ASSERT_FALSE(set1 == set2);
+
+    set1.remove(500);
+    set1.add(-1);
+    ASSERT_FALSE(set1 <= set2);
+    ASSERT_FALSE(set2 >= set1);
+}
+
+TEST(OrderedSetTest, popMinMaxTest) {
+    OrderedSet<int> set;
+    int a[9] = {9, 5, 6, 7, 2, 3, 8, 1, 4};
+    for (int i = 0; i < 9; i++) {
+        set.add(a[i]);
+    }
+    ASSERT_EQ(1, set.popMin());
+    ASSERT_EQ(9, set.popMax());
+    ASSERT_EQ(2, set.min());
+    ASSERT_EQ(8, set.max());
+    ASSERT_EQ(7, set.getSize());
+    for (int i = 2; i < 9; i++) {
+        ASSERT_EQ(i, set.popMin());
+        ASSERT_EQ(8 - i, set.getSize());
+    }
+    try {
+        set.popMax();
+        ASSERT_TRUE(false);
+    } catch (EmptySetException &e) {
+        std::string a = "Set is empty!";
+        ASSERT_EQ(a, e.what());
+    }
+    set.add(3);
+    ASSERT_EQ(3, set.min());
+    ASSERT_EQ(3, set.max());
+}
+
+TEST(OrderedSetTest, removeAtTest) {
+    OrderedSet<int> set;
+    int a[11] = {6, 1, 9, 7, 3, 2, 8, 5, 10, 4, 0};
+    for (int i = 0; i < 11; i++) {
+        set.add(a[i]);
+    }
+    ASSERT_EQ(5, set.removeAt(5));
+    ASSERT_EQ(10, set.getSize());
+    ASSERT_FALSE(set.contains(5));
+    ASSERT_EQ(6, set.getItem(5));
+    ASSERT_EQ(0, set.removeAt(0));
+    ASSERT_EQ(1, set.min());
+    ASSERT_EQ(10, set.removeAt(set.getSize() - 1));
+    ASSERT_EQ(9, set.max());
+    for (int i = 0; i < set.getSize(); i++) {
+        ASSERT_EQ(i, set.getIndex(set.getItem(i)));
+    }
+    try {
+        set.removeAt(8);
+        ASSERT_TRUE(false);
+    } catch (IndexOutOfRangeException &e) {
+        std::string a = "Index is out of range!";
+        ASSERT_EQ(a, e.what());
+    }
+}
+
+TEST(OrderedSetTest, sumAggregateTest) {
+    OrderedSet<int, HashOrder, SumAggregate<int>> set;
+    for (int i = 0; i < 200; i++) {
+        set.add((i * 37) % 200);
+    }
+    ASSERT_EQ(199 * 200 / 2, set.getAggregate());
+    ASSERT_EQ(10 + 11 + 12, set.getAggregate(10, 12));
+    ASSERT_EQ(0, set.getAggregate(12, 10));
+    ASSERT_EQ(5, set.getAggregate(5, 5));
+
+    for (int i = 0; i < 200; i += 2) {
+        set.remove(i);
+    }
+    set.popMin();
+    set.popMax();
+    set.removeAt(0);
+    int expected = 0;
+    for (int i = 5; i < 199; i += 2) {
+        expected += i;
+    }
+    ASSERT_EQ(expected, set.getAggregate());
+    ASSERT_EQ(expected, set.getAggregate(0, 1000));
+    ASSERT_EQ(21 + 23 + 25, set.getAggregate(20, 26));
+
+    OrderedSet<int, HashOrder, SumAggregate<int>> other;
+    for (int i = 0; i < 10; i++) {
+        other.add(i);
+    }
+    set.unionWith(other);
+    ASSERT_EQ(expected + 45 - 5 - 7 - 9, set.getAggregate());
+}
+
+TEST(OrderedSetTest, payloadAggregateTest) {
+    struct Sample {
+        int time;
+        double value;
+    };
+    struct MaxValue {
+        using value_type = double;
+        static double identity() {return -1;};
+        static double of(const Sample &sample) {return sample.value;};
+        static double combine(double a, double b) {return std::max(a, b);};
+    };
+    OrderedSet<Sample, HashOrder, MaxValue> window;
+    double values[8] = {1.5, 7, 3, 2, 9, 4, 0.5, 6};
+    for (int i = 0; i < 8; i++) {
+        window.add(Sample{i, values[i]}, i);
+    }
+    ASSERT_EQ(9, window.getAggregate());
+    ASSERT_EQ(7, window.getAggregate(Sample{0, 0}, 0, Sample{3, 0}, 3));
+    ASSERT_EQ(6, window.getAggregate(Sample{5, 0}, 5, Sample{7, 0}, 7));
+    window.popMin();
+    window.popMin();
+    ASSERT_EQ(3, window.getAggregate(Sample{0, 0}, 0, Sample{3, 0}, 3));
+
+    OrderedSet<int, HashOrder, MinAggregate<int>> minimums;
+    minimums.addMultiple(5, 3, 8, 1);
+    ASSERT_EQ(1, minimums.getAggregate());
+    ASSERT_EQ(3, minimums.getAggregate(2, 8));
+}
+
+TEST(OrderedSetTest, stringCompareTest) {
+    OrderedSet<std::string, std::less<std::string>> set;
+    set.addMultiple(std::string("pear"), std::string("apple"), std::string("plum"), std::string("banana"),
+                    std::string("apple"), std::string("peach"), std::string("apricot"));
+    ASSERT_EQ(6, set.getSize());
+    ASSERT_EQ("apple", set.min());
+    ASSERT_EQ("plum", set.max());
+    ASSERT_EQ("banana", set.getItem(2));
+    ASSERT_EQ(3, set.getIndex("peach"));
+    std::string *list = set.getSortedList();
+    for (int i = 1; i < 6; i++) {
+        ASSERT_TRUE(list[i-1] < list[i]);
+    }
+    delete[] list;
+
+    std::string found;
+    set.forEachWithPrefix("pe", [&](std::string value) {found += value + ",";});
+    ASSERT_EQ("peach,pear,", found);
+    found.clear();
+    set.forEachWithPrefix("ap", [&](std::string value) {found += value + ",";});
+    ASSERT_EQ("apple,apricot,", found);
+    found.clear();
+    set.forEachWithPrefix("x", [&](std::string value) {found += value + ",";});
+    ASSERT_EQ("", found);
+
+    set.remove("pear");
+    ASSERT_FALSE(set.contains("pear"));
+    ASSERT_EQ("plum", set.popMax());
+    ASSERT_EQ("peach", set.max());
+}
+
+TEST(OrderedSetTest, charPointerCompareTest) {
+    OrderedSet<char *, CStringLess> set;
+    char a[] = "ab";
+    char b[] = "ba";
+    char c[] = "aa";
+    char d[] = "aaa";
+    char e[] = "aba";
+    char f[] = "aaaa";
+    set.addMultiple(a, b, c, d, e, f);
+    char **list = set.getSortedList();
+    ASSERT_EQ(0, strcmp("aa", list[0]));
+    ASSERT_EQ(0, strcmp("aaa", list[1]));
+    ASSERT_EQ(0, strcmp("aaaa", list[2]));
+    ASSERT_EQ(0, strcmp("ab", list[3]));
+    ASSERT_EQ(0, strcmp("aba", list[4]));
+    ASSERT_EQ(0, strcmp("ba", list[5]));
+    delete[] list;
+
+    char other[] = "ab";
+    ASSERT_TRUE(set.contains(other));
+    int count = 0;
+    char prefix[] = "aa";
+    set.forEachWithPrefix(prefix, [&](char *value) {count++;});
+    ASSERT_EQ(3, count);
+
+    OrderedSet<char *, CStringLess> set2;
+    set2.addMultiple(other, b);
+    ASSERT_TRUE(set2 < set);
+    ASSERT_EQ(2, set.setIntersection(set2).getSize());
+}
+
+TEST(OrderedSetTest, nodeReuseTest) {
+    OrderedSet<int> set;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 1000; i++) {
+            set.add((i * 41) % 1000);
+        }
+        ASSERT_EQ(1000, set.getSize());
+        for (int i = 0; i < 1000; i += 2) {
+            set.remove(i);
+        }
+        ASSERT_EQ(500, set.getSize());
+        ASSERT_EQ(1, set.min());
+        ASSERT_EQ(999, set.max());
+        ASSERT_EQ(3, set.getItem(1));
+        set.clear();
+        ASSERT_EQ(0, set.getSize());
+        ASSERT_FALSE(set.contains(1));
+    }
+    OrderedSet<std::string, std::less<std::string>> words;
+    words.addMultiple("b", "a", "c");
+    words.clear();
+    words.addMultiple("e", "d");
+    ASSERT_EQ(2, words.getSize());
+    ASSERT_EQ("d", words.min());
+}
+
+TEST(OrderedSetTest, parallelWalkTest) {
+    OrderedSet<int> set;
+    int n = 20000;
+    for (int i = 0; i < n; i++) {
+        set.add((i * 7919) % n);
+    }
+    int *list = set.getSortedList();
+    for (int i = 0; i < n; i++) {
+        ASSERT_EQ(i, list[i]);
+    }
+    delete[] list;
+    std::atomic<long> sum(0), count(0);
+    set.forEach([&](int value) {
+        sum += value;
+        count++;
+    });
+    ASSERT_EQ(n, count);
+    ASSERT_EQ(long(n) * (n - 1) / 2, sum);
+
+    OrderedSet<int> chain; // every node only has a right child
+    for (int i = 0; i < 5000; i++) {
+        chain.add(i);
+    }
+    list = chain.getSortedList();
+    ASSERT_EQ(0, list[0]);
+    ASSERT_EQ(4999, list[4999]);
+    delete[] list;
+}
+
+TEST(OrderedSetTest, nearlySortedTest) {
+    OrderedSet<long, HashOrder, SumAggregate<long>> set;
+    long n = 100000;
+    for (long i = 0; i < n; i++) {
+        set.add(i + (i % 4 == 1 ? 2 : 0)); // one of four keys arrives two places early
+    }
+    for (long i = 0; i < n; i++) {
+        set.add(i);
+    }
+    ASSERT_EQ(n, set.getSize());
+    ASSERT_EQ(0, set.min());
+    ASSERT_EQ(n - 1, set.max());
+    ASSERT_EQ(500, set.getItem(500));
+    ASSERT_EQ(777, set.getIndex(777));
+    ASSERT_TRUE(set.contains(n - 1));
+    ASSERT_FALSE(set.contains(n));
+    ASSERT_EQ(n * (n - 1) / 2, set.getAggregate());
+    ASSERT_EQ(55, set.getAggregate(1, 10));
+    set.remove(5);
+    ASSERT_FALSE(set.contains(5));
+    ASSERT_TRUE(set.contains(6));
+    ASSERT_EQ(50, set.getAggregate(1, 10));
+}
+
+TEST(OrderedSetTest, addSortedRunTest) {
+    OrderedSet<int> set;
+    set.addMultiple(1, 5, 9);
+    std::vector<int> run = {2, 3, 5, 10};
+    set.addSortedRun(run.begin(), run.end());
+    ASSERT_EQ(6, set.getSize());
+    int unsorted[4] = {7, 4, 4, 0};
+    set.addSortedRun(unsorted, unsorted + 4);
+    ASSERT_EQ(9, set.getSize());
+    int expected[9] = {0, 1, 2, 3, 4, 5, 7, 9, 10};
+    int *list = set.getSortedList();
+    for (int i = 0; i < 9; i++) {
+        ASSERT_EQ(expected[i], list[i]);
+        ASSERT_EQ(i, set.getIndex(expected[i]));
+    }
+    delete[] list;
+    ASSERT_EQ(0, set.min());
+    ASSERT_EQ(10, set.max());
+    set.add(6);
+    ASSERT_EQ(6, set.getItem(6));
+
+    OrderedSet<int> empty;
+    empty.addSortedRun(run.begin(), run.begin());
+    ASSERT_EQ(0, empty.getSize());
+    empty.addSortedRun(run.begin(), run.end());
+    ASSERT_EQ(2, empty.min());
+}
+
+TEST(OrderedSetTest, batchLookupTest) {
+    OrderedSet<int> set;
+    for (int i = 0; i < 1000; i += 2) {
+        set.add(i);
+    }
+    std::vector<int> values;
+    for (int i = -5; i < 1005; i++) {
+        values.push_back(i);
+    }
+    bool *found = new bool[values.size()];
+    set.containsBatch(values.data(), values.size(), found);
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(set.contains(values[i]), found[i]);
+    }
+    delete[] found;
+
+    std::vector<int> present = {998, 0, 500, 2, 2, 36};
+    size_t indexes[7];
+    set.getIndexBatch(present.data(), present.size(), indexes);
+    for (size_t i = 0; i < present.size(); i++) {
+        ASSERT_EQ(set.getIndex(present[i]), indexes[i]);
+    }
+    present.push_back(7);
+    ASSERT_THROW(set.getIndexBatch(present.data(), present.size(), indexes), ValueNotFoundException);
+
+    OrderedSet<int> empty;
+    bool none[2] = {true, true};
+    empty.containsBatch(values.data(), 2, none);
+    ASSERT_FALSE(none[0] || none[1]);
+    empty.containsBatch(values.data(), 0, none);
+}
+
+TEST(OrderedSetTest, stringBatchLookupTest) {
+    OrderedSet<std::string, std::less<std::string>> set;
+    set.addMultiple(std::string("pear"), std::string("apple"), std::string("plum"), std::string("fig"));
+    std::string values[5] = {"plum", "kiwi", "apple", "fig", "pear"};
+    bool found[5];
+    set.containsBatch(values, 5, found);
+    ASSERT_TRUE(found[0] && !found[1] && found[2] && found[3] && found[4]);
+    std::string present[3] = {"plum", "apple", "pear"};
+    size_t indexes[3];
+    set.getIndexBatch(present, 3, indexes);
+    ASSERT_EQ(3, indexes[0]);
+    ASSERT_EQ(0, indexes[1]);
+    ASSERT_EQ(2, indexes[2]);
+}
+
+TEST(OrderedSetTest, bidirectionalIteratorTest) {
+    OrderedSet<int> set;
+    for (int i = 0; i < 500; i++) {
+        set.add((i * 37) % 500 * 2);
+    }
+    auto iter = set.getIteratorAt(100);
+    for (int i = 100; i < 150; i++, ++iter) {
+        ASSERT_EQ(i * 2, iter.getData());
+        ASSERT_EQ(i, iter.getIndex());
+    }
+    for (int i = 150; i > 0; i--) {
+        --iter;
+        ASSERT_EQ((i - 1) * 2, iter.getData());
+    }
+    --iter;
+    ASSERT_FALSE(iter.finished());
+    ASSERT_THROW(--iter, IndexOutOfRangeException);
+    ++iter;
+    ASSERT_EQ(0, iter.getData());
+
+    int i = 499;
+    for (auto reverse = set.getReverseIterator(); reverse.finished(); --reverse, i--) {
+        ASSERT_EQ(i * 2, reverse.getData());
+    }
+    ASSERT_EQ(-1, i);
+    auto end = set.getIteratorAt(500);
+    ASSERT_FALSE(end.finished());
+    ASSERT_THROW(++end, IndexOutOfRangeException);
+    --end;
+    ASSERT_EQ(998, end.getData());
+    ASSERT_THROW(set.getIteratorAt(501), IndexOutOfRangeException);
+
+    OrderedSet<int> empty;
+    ASSERT_FALSE(empty.getReverseIterator().finished());
+    ASSERT_FALSE(empty.getIteratorFrom(3).finished());
+}
+
+TEST(OrderedSetTest, iteratorFromTest) {
+    OrderedSet<std::string, std::less<std::string>> set;
+    set.addMultiple(std::string("b"), std::string("d"), std::string("f"), std::string("h"));
+    auto iter = set.getIteratorFrom("d");
+    ASSERT_EQ("d", iter.getData());
+    ASSERT_EQ(1, iter.getIndex());
+    iter = set.getIteratorFrom("e");
+    ASSERT_EQ("f", iter.getData());
+    ASSERT_EQ(2, iter.getIndex());
+    ++iter;
+    ASSERT_EQ("h", iter.getData());
+    --iter;
+    --iter;
+    ASSERT_EQ("d", iter.getData());
+    ASSERT_EQ("b", set.getIteratorFrom("a").getData());
+    iter = set.getIteratorFrom("i");
+    ASSERT_FALSE(iter.finished());
+    ASSERT_EQ(4, iter.getIndex());
+    --iter;
+    ASSERT_EQ("h", iter.getData());
+}
+
+TEST(OrderedSetTest, fillAndCopyToTest) {
+    OrderedSet<int> set;
+    for (int i = 0; i < 5000; i++) {
+        set.add((i * 7919) % 5000);
+    }
+    std::vector<int> buffer(5001, -1), copied;
+    ASSERT_EQ(5000, set.fill(buffer));
+    ASSERT_EQ(-1, buffer[5000]);
+    set.copyTo(std::back_inserter(copied));
+    int *list = set.getSortedList();
+    for (int i = 0; i < 5000; i++) {
+        ASSERT_EQ(i, buffer[i]);
+        ASSERT_EQ(i, copied[i]);
+        ASSERT_EQ(i, list[i]);
+    }
+    delete[] list;
+    ASSERT_THROW(set.fill(ArrayView<int>(buffer).subView(0, 4999)), IndexOutOfRangeException);
+    ASSERT_THROW(ArrayView<int>(buffer).subView(5000, 2), IndexOutOfRangeException);
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <set>
+#include <random>
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+
+#include "PartitionedCombinedSet.h"
+
+TEST(PartitionedCombinedSetTest, test) {
+    PartitionedCombinedSet<int, double, std::string> set;
+    set.addMultiple(1, 2, 1, std::string("ab"));
+    set.add(1.0, 1);
+    set.add(2.5, 2);
+    ASSERT_EQ(5, set.getSize());
+    ASSERT_EQ(2, set.getSize<int>());
+    ASSERT_EQ(2, set.getSize<double>());
+    ASSERT_EQ(1, set.getSize<std::string>());
+    ASSERT_TRUE(set.contains(1));
+    ASSERT_TRUE(set.contains(1.0, 1)); // same key as int 1, but another type
+    ASSERT_FALSE(set.contains(3));
+    set.remove(1);
+    ASSERT_FALSE(set.contains(1));
+    ASSERT_TRUE(set.contains(1.0, 1));
+    ASSERT_THROW(set.remove(1), ValueNotFoundException);
+    ASSERT_THROW(set.add(true), TypeNotAcceptedException);
+    ASSERT_THROW(set.getSize<char>(), TypeNotAcceptedException);
+    int sum = 0;
+    for (auto iter = set.getIterator<int>(); iter.finished(); ++iter) {
+        sum += iter.getData();
+    }
+    ASSERT_EQ(2, sum);
+    size_t count = 0;
+    set.forEach([&](auto &) {count++;});
+    ASSERT_EQ(4, count);
+    set.clear();
+    ASSERT_EQ(0, set.getSize());
+    for (auto iter = set.getIterator<double>(); iter.finished(); ++iter) {
+        ASSERT_TRUE(false);
+    }
+}
+
+TEST(PartitionedCombinedSetTest, randomTest) {
+    std::mt19937 generator(5);
+    PartitionedCombinedSet<int, long> set;
+    std::set<int> ints;
+    std::set<long> longs;
+    for (int i = 0; i < 20000; i++) {
+        int value = generator() % 500;
+        bool asLong = generator() % 2 == 0;
+        if (generator() % 3 != 0) {
+            asLong ? set.add(long(value)) : set.add(value);
+            asLong ? (void) longs.insert(value) : (void) ints.insert(value);
+        } else if (asLong ? longs.count(value) > 0 : ints.count(value) > 0) {
+            asLong ? set.remove(long(value)) : set.remove(value);
+            asLong ? (void) longs.erase(value) : (void) ints.erase(value);
+        }
+        ASSERT_EQ(ints.size(), set.getSize<int>());
+        ASSERT_EQ(longs.size(), set.getSize<long>());
+        ASSERT_EQ(ints.count(value) > 0, set.contains(value));
+        ASSERT_EQ(longs.count(value) > 0, set.contains(long(value)));
+    }
+    std::set<int> seen;
+    set.forEach<int>([&](int value) {seen.insert(value);});
+    ASSERT_TRUE(seen == ints);
+}
+
+TEST(PartitionedCombinedSetTest, setOperationsTest) {
+    PartitionedCombinedSet<int, long> a, b;
+    for (int i = 0; i < 10000; i++) {
+        a.add(i);
+        b.add(i + 5000);
+        a.add(long(i * 2));
+        b.add(long(i * 3));
+    }
+    auto together = a.setUnion(b);
+    ASSERT_EQ(15000, together.getSize<int>());
+    ASSERT_EQ(10000 + 10000 - 3334, together.getSize<long>());
+    auto common = a.setIntersection(b);
+    ASSERT_EQ(5000, common.getSize<int>());
+    ASSERT_EQ(3334, common.getSize<long>());
+    ASSERT_TRUE(common.contains(long(6)));
+    ASSERT_FALSE(common.contains(long(4)));
+    ASSERT_TRUE(common < a);
+    ASSERT_TRUE(common <= b);
+    ASSERT_TRUE(together > b);
+    ASSERT_FALSE(a == b);
+    ASSERT_TRUE(together == b.setUnion(a)); // takes temporaries, like CombinedSet
+    ASSERT_TRUE(common <= a.setIntersection(b));
+    auto copy = a;
+    ASSERT_TRUE(copy == a);
+    copy.remove(0);
+    ASSERT_TRUE(a.contains(0)); // copies have their own tables
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <thread>
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+
+#include "PersistentOrderedSet.h"
+
+TEST(PersistentOrderedSetTest, VersionsTest) {
+    PersistentOrderedSet<int> empty;
+    PersistentOrderedSet<int> a = empty.addMultiple(5, 1, 3);
+    PersistentOrderedSet<int> b = a.add(2);
+    PersistentOrderedSet<int> c = b.remove(5);
+    ASSERT_EQ(0, empty.getSize());
+    ASSERT_EQ(3, a.getSize());
+    ASSERT_EQ(4, b.getSize());
+    ASSERT_EQ(3, c.getSize());
+    ASSERT_FALSE(a.contains(2));
+    ASSERT_TRUE(b.contains(2));
+    ASSERT_TRUE(b.contains(5));
+    ASSERT_FALSE(c.contains(5));
+    ASSERT_EQ(5, a.max());
+    ASSERT_EQ(3, c.max());
+    ASSERT_EQ(1, c.min());
+    ASSERT_EQ(2, b.getIndex(3));
+    ASSERT_EQ(5, b.getItem(3));
+    ASSERT_EQ(3, a.add(3).getSize());
+}
+
+TEST(PersistentOrderedSetTest, SnapshotTest) {
+    for (int n = 0; n < 200; n += 13) {
+        PersistentOrderedSet<int> set;
+        std::vector<PersistentOrderedSet<int>> snapshots;
+        for (int i = 0; i < n; i++) {
+            snapshots.push_back(set);
+            set = set.add((i * 41) % n);
+        }
+        for (int i = 0; i < n; i += 2) {
+            set = set.remove(i);
+        }
+        ASSERT_EQ(n / 2, set.getSize());
+        for (int i = 0; i < n; i++) {
+            ASSERT_EQ(i, snapshots[i].getSize());
+            ASSERT_EQ(i % 2 == 1, set.contains(i));
+        }
+        int i = 0;
+        for (auto iter = set.getIterator(); iter.finished(); ++iter, i++) {
+            ASSERT_EQ(2 * i + 1, iter.getData());
+            ASSERT_EQ(2 * i + 1, set.getItem(i));
+        }
+        ASSERT_EQ(n / 2, i);
+    }
+}
+
+TEST(PersistentOrderedSetTest, FromOrderedSetTest) {
+    OrderedSet<const char*, CStringLess> words;
+    words.addMultiple("pear", "apple", "fig");
+    PersistentOrderedSet<const char*, CStringLess> snapshot(words);
+    words.add("kiwi");
+    ASSERT_EQ(3, snapshot.getSize());
+    ASSERT_STREQ("apple", snapshot.min());
+    ASSERT_STREQ("pear", snapshot.max());
+    ASSERT_EQ(1, snapshot.getIndex("fig"));
+    ASSERT_FALSE(snapshot.contains("kiwi"));
+    try {
+        snapshot.remove("kiwi");
+        ASSERT_TRUE(false);
+    } catch (ValueNotFoundException &e) {
+        std::string a = "Value not found!";
+        ASSERT_EQ(a, e.what());
+    }
+    try {
+        PersistentOrderedSet<int>().min();
+        ASSERT_TRUE(false);
+    } catch (EmptySetException &e) {
+        std::string a = "Set is empty!";
+        ASSERT_EQ(a, e.what());
+    }
+}
+
+TEST(PersistentOrderedSetTest, ReaderThreadTest) {
+    PersistentOrderedSet<int> set;
+    for (int i = 0; i < 1000; i++) {
+        set = set.add(i);
+    }
+    PersistentOrderedSet<int> snapshot = set;
+    std::thread reader([snapshot]() mutable {
+        for (int round = 0; round < 20; round++) {
+            long sum = 0;
+            for (auto iter = snapshot.getIterator(); iter.finished(); ++iter) {
+                sum += iter.getData();
+            }
+            ASSERT_EQ(499500, sum);
+        }
+    });
+    for (int i = 0; i < 1000; i++) {
+        set = set.remove(i).add(i + 1000);
+    }
+    reader.join();
+    ASSERT_EQ(1000, set.getSize());
+    ASSERT_EQ(1000, set.min());
+    ASSERT_EQ(1000, snapshot.getSize());
+}
+
+TEST(PersistentOrderedSetTest, BigKeyTest) {
+    OrderedSet<std::string> strings;
+    strings.addMultiple("pear", "apple", "banana", "zucchini"); // hash of zucchini is above INT_MAX
+    PersistentOrderedSet<std::string> snapshot(strings);
+    for (std::string value : {"pear", "apple", "banana", "zucchini"}) {
+        ASSERT_TRUE(snapshot.contains(value));
+    }
+    ASSERT_EQ(strings.getIndex("zucchini"), snapshot.getIndex("zucchini"));
+    unsigned list[] = {1, 5, 3000000000u};
+    OrderedSet<unsigned> source;
+    source.addMultiple(list[0], list[1], list[2]);
+    unsigned *sorted = source.getSortedList();
+    PersistentOrderedSet<unsigned> set(sorted, 3);
+    delete[] sorted;
+    ASSERT_TRUE(set.contains(3000000000u));
+    set = set.add(7);
+    ASSERT_TRUE(set.contains(3000000000u));
+    ASSERT_EQ(3000000000u, set.getItem(3)); // same place as in OrderedSet
+    ASSERT_EQ(source.getIndex(3000000000u) + 1, set.getIndex(3000000000u));
+    set = set.remove(3000000000u);
+    ASSERT_EQ(3, set.getSize());
+}
\ No newline at end of file
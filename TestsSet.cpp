@@ -330,4 +330,23 @@ TEST(SetTest, SubSetTest) {
     ASSERT_FALSE(set2 == set1);
     ASSERT_FALSE(set2 <= set1);
     ASSERT_TRUE(set2 >= set1);
+}
+
+TEST(SetTest, FillAndCopyToTest) {
+    Set<int> set;
+    set.addMultiple(3, 1, 4, 15, 9);
+    int buffer[6] = {0, 0, 0, 0, 0, -1};
+    ASSERT_EQ(5, set.fill(buffer));
+    ASSERT_EQ(-1, buffer[5]);
+    int sum = 0;
+    for (int value : ArrayView<int>(buffer).subView(0, 5)) {
+        sum += value;
+    }
+    ASSERT_EQ(32, sum);
+    std::vector<int> copied;
+    set.copyTo(std::back_inserter(copied));
+    ASSERT_EQ(5, copied.size());
+    ASSERT_THROW(set.fill(ArrayView<int>(buffer, 4)), IndexOutOfRangeException);
+    Set<int> empty;
+    ASSERT_EQ(0, empty.fill(ArrayView<int>()));
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+
+#include "SlotMap.h"
+
+TEST(SlotMapTest, test) {
+    SlotMap<std::string> map;
+    auto a = map.add("a");
+    auto b = map.add("b");
+    auto c = map.add("c");
+    ASSERT_EQ(3, map.getSize());
+    ASSERT_EQ("b", map.get(b));
+    map.remove(a);
+    ASSERT_FALSE(map.contains(a));
+    ASSERT_THROW(map.get(a), ValueNotFoundException);
+    ASSERT_THROW(map.remove(a), ValueNotFoundException);
+    ASSERT_EQ("c", map.getValues()[0]); // the last value took the place of the removed one
+    auto d = map.add("d"); // reuses the slot of a with a new generation
+    ASSERT_FALSE(map.contains(a));
+    ASSERT_TRUE(a != d);
+    ASSERT_EQ("d", map.get(d));
+    map.get(c) = "cc";
+    std::string all;
+    for (auto iter = map.getIterator(); iter.finished(); ++iter) {
+        all += iter.getData();
+        ASSERT_EQ(iter.getData(), map.get(iter.getHandle()));
+    }
+    ASSERT_EQ("ccbd", all);
+    ASSERT_FALSE(map.contains(SlotMap<std::string>::Handle()));
+    map.clear();
+    ASSERT_EQ(0, map.getSize());
+    ASSERT_FALSE(map.contains(b));
+    ASSERT_THROW(map.getIterator().getData(), EmptySetException);
+    auto e = map.add("e");
+    ASSERT_TRUE(map.contains(e));
+    ASSERT_FALSE(map.contains(b));
+}
+
+TEST(SlotMapTest, randomTest) {
+    std::mt19937 generator(19);
+    SlotMap<int> map;
+    std::vector<SlotMap<int>::Handle> handles, removed;
+    std::map<int, SlotMap<int>::Handle> reference;
+    for (int i = 0; i < 20000; i++) {
+        if (handles.empty() || generator() % 3 != 0) {
+            handles.push_back(map.add(i));
+            reference[i] = handles.back();
+        } else {
+            size_t k = generator() % handles.size();
+            int value = map.get(handles[k]);
+            map.remove(handles[k]);
+            reference.erase(value);
+            removed.push_back(handles[k]);
+            handles[k] = handles.back();
+            handles.pop_back();
+        }
+        ASSERT_EQ(reference.size(), map.getSize());
+    }
+    for (auto &handle : removed) {
+        ASSERT_FALSE(map.contains(handle));
+    }
+    for (auto &entry : reference) {
+        ASSERT_EQ(entry.first, map.get(entry.second));
+    }
+    long sum = 0, expected = 0;
+    map.forEach([&](int value) {sum += value;});
+    for (auto &entry : reference) {
+        expected += entry.first;
+    }
+    ASSERT_EQ(expected, sum);
+}
\ No newline at end of file
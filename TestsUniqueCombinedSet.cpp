@@ -1,4 +1,7 @@
 #include <iostream>
+#include <set>
+#include <random>
+#include <vector>
 #include "gtest/gtest.h"
 
 
@@ -286,4 +289,89 @@ TEST(UniqueCombinedSetTest, clearTest) {
     for (auto iter = set.getIterator(); iter.finished(); ++iter) {
         ASSERT_TRUE(false);
     }
+}
+
+TEST(UniqueCombinedSetTest, ManyTypesTest) {
+    UniqueCombinedSet<char, short, int, long, float, double, bool, unsigned, std::string, char *> set(4);
+    int a = 1, b = 1;
+    double c = 1;
+    std::string d = "x";
+    bool e = true;
+    set.addMultiple(a, b, c, d, e);
+    ASSERT_EQ(5, set.getSize());
+    ASSERT_TRUE(set.contains(d));
+    set.remove(a);
+    ASSERT_FALSE(set.contains(a));
+    ASSERT_TRUE(set.contains(b));
+    int count = 0;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter, count++) {
+        try {
+            ASSERT_EQ("x", iter.getData<std::string>());
+        } catch (WrongTypeException &) {
+            ASSERT_THROW(iter.getData<long>(), WrongTypeException);
+        }
+    }
+    ASSERT_EQ(4, count);
+    ASSERT_EQ(8, set.getCapacity());
+}
+
+TEST(UniqueCombinedSetTest, SameAddressTest) {
+    struct Pair {
+        int first;
+        int second;
+    };
+    Pair pair{1, 2};
+    UniqueCombinedSet<int, Pair> set;
+    set.add(pair);
+    set.add(pair.first); // same address as pair, but another type
+    ASSERT_EQ(2, set.getSize());
+    set.remove(pair);
+    ASSERT_TRUE(set.contains(pair.first));
+    ASSERT_FALSE(set.contains(pair));
+    ASSERT_EQ(1, set.getIterator().getData<int>());
+}
+
+TEST(UniqueCombinedSetTest, RandomAddRemoveTest) {
+    std::mt19937 generator(7);
+    std::vector<int> ints(300);
+    std::vector<long> longs(300);
+    std::set<void *> reference;
+    UniqueCombinedSet<int, long> set(3);
+    for (int i = 0; i < 20000; i++) {
+        size_t index = generator() % 300;
+        bool isLong = generator() % 2 == 0;
+        void *address = isLong ? (void *) &longs[index] : (void *) &ints[index];
+        if (generator() % 3 != 0) {
+            isLong ? set.add(longs[index]) : set.add(ints[index]);
+            reference.insert(address);
+        } else if (reference.count(address) > 0) {
+            isLong ? set.remove(longs[index]) : set.remove(ints[index]);
+            reference.erase(address);
+        }
+        ASSERT_EQ(reference.size(), set.getSize());
+        ASSERT_EQ(reference.count(&ints[index]) > 0, set.contains(ints[index]));
+        ASSERT_EQ(reference.count(&longs[index]) > 0, set.contains(longs[index]));
+    }
+    size_t count = 0;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+        count++;
+    }
+    ASSERT_EQ(reference.size(), count);
+}
+
+TEST(UniqueCombinedSetTest, GetPointerTest) {
+    int a = 1;
+    std::string b = "b";
+    UniqueCombinedSet<int, std::string> set;
+    set.addMultiple(a, b);
+    for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+        try {
+            ASSERT_EQ(&b, iter.getPointer<std::string>());
+        } catch (WrongTypeException &) {
+            *iter.getPointer<int>() = 2;
+        }
+    }
+    ASSERT_EQ(2, a);
+    set.clear();
+    ASSERT_THROW(set.getIterator().getPointer<int>(), EmptySetException);
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include <iostream>
+#include <set>
+#include <random>
+#include <vector>
 #include "gtest/gtest.h"
 
 
@@ -375,4 +378,66 @@ TEST(UniqueSetTest, addMultipleTest) {
     ASSERT_TRUE(set.contains(b));
     ASSERT_TRUE(set.contains(c));
     ASSERT_TRUE(set.contains(d));
+}
+
+TEST(UniqueSetTest, EmptyIteratorTest) {
+    UniqueSet<int> set;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+        ASSERT_TRUE(false);
+    }
+    ASSERT_THROW(set.getIterator().getData(), EmptySetException);
+}
+
+TEST(UniqueSetTest, RandomAddRemoveTest) {
+    std::mt19937 generator(9);
+    std::vector<double> values(500);
+    std::set<double *> reference;
+    UniqueSet<double> set(3);
+    for (int i = 0; i < 20000; i++) {
+        double *value = &values[generator() % values.size()];
+        if (generator() % 3 != 0) {
+            set.add(*value);
+            reference.insert(value);
+        } else if (reference.count(value) > 0) {
+            set.remove(*value);
+            reference.erase(value);
+        } else {
+            ASSERT_THROW(set.remove(*value), ValueNotFoundException);
+        }
+        ASSERT_EQ(reference.size(), set.getSize());
+        ASSERT_TRUE(set.contains(*value) == (reference.count(value) > 0));
+    }
+    size_t count = 0;
+    for (auto iter = set.getIterator(); iter.finished(); ++iter) {
+        count++;
+    }
+    ASSERT_EQ(reference.size(), count);
+}
+
+TEST(UniqueSetTest, PointerViewTest) {
+    std::vector<std::string> objects(100, "x");
+    UniqueSet<std::string> set;
+    for (auto &object : objects) {
+        set.add(object);
+    }
+    std::vector<std::string *> pointers(100);
+    ASSERT_EQ(100, set.fill(pointers));
+    std::set<std::string *> reference;
+    for (auto &object : objects) {
+        reference.insert(&object);
+    }
+    ASSERT_TRUE(std::set<std::string *>(pointers.begin(), pointers.end()) == reference);
+    size_t used = 0;
+    for (std::string *slot : set.getSlots()) {
+        if (slot != nullptr) {
+            ASSERT_EQ(1, reference.count(slot));
+            used++;
+        }
+    }
+    ASSERT_EQ(100, used);
+    ASSERT_EQ(set.getCapacity(), set.getSlots().getSize());
+    std::vector<std::string *> copied;
+    set.copyTo(std::back_inserter(copied));
+    ASSERT_TRUE(copied == pointers);
+    ASSERT_THROW(set.fill(ArrayView<std::string *>(pointers.data(), 99)), IndexOutOfRangeException);
 }
\ No newline at end of file
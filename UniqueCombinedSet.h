@@ -5,8 +5,8 @@
 #include <cmath>
 #include <stdexcept>
 #include <type_traits>
-#include <tuple>
-#include <cassert>
+#include <cstdint>
+#include <algorithm>
 #include "Exceptions.h"
 
 
@@ -14,201 +14,74 @@ template<class... types> class UniqueCombinedSet {
     const float RESIZE_AT = 0.75;
     const int MULTIPLY_SIZE_BY = 2;
 
-    class Type {
-        size_t index;
-    public:
-        Type(size_t i) : index(i) {};
-        size_t getTypeId() { return index; };
-    };
-
-    template<typename T>
-    class Node {
-        T* data;
-        size_t key;
-    public:
-        Node(T* data, size_t key) : data(data), key(key) {};
-        bool operator==(Node &node) { return key == node.key; };
-        T getData() { return *data; };
-        T *getDataPointer() {return data;}
-        size_t getKey() { return key; };
-    };
-
-    class Wrap {
-        void *node = nullptr;
-        Type *type = nullptr;
-        Wrap *next = nullptr;
-    public:
-        Wrap(void *n, Type *t) : node(n), type(t) {};
-        ~Wrap() {
-            const size_t i = type->getTypeId();
-            deleteThem<typeArraySize>(i);
-        }
-
-        bool operator==(Wrap &other) {
-            if (type->getTypeId() != other.getType()->getTypeId()) {
-                return false;
-            }
-            const size_t i = type->getTypeId();
-            return equal<typeArraySize>(i, other);
-        }
-
-        void *getNode() { return node; };
-        Type *getType() { return type; };
-        Wrap *getNext() { return next; };
-        template<typename T>
-        T getData() {
-            if (!checkType<T, typeArraySize>(type->getTypeId())) {
-                throw WrongTypeException();
-            }
-            Node<T> *n = static_cast<Node<T> *>(node);
-            return n->getData();
-        }
-        size_t getKey() { return getNodeKey<typeArraySize>(type->getTypeId()); };
-        void setNext(Wrap *n) { (next == nullptr) ? next = n : throw OccupiedSpaceException(); };
-
-    private:
-        template<size_t I, std::enable_if_t<0 < I, bool> = true>
-        size_t getNodeKey(size_t i) {
-            if (I > typeArraySize || I - 1 < i) {
-                throw TypeNotAcceptedException();
-            }
-            if (I - 1 > i) {
-                return getNodeKey<I - 1>(i);;
-            }
-            using t = typename std::tuple_element<I - 1, typeArray>::type;
-            Node<t> *n = static_cast<Node<t> *>(node);
-            return n->getKey();
-        }
-
-        template<size_t I, std::enable_if_t<0 == I, bool> = true>
-        size_t getNodeKey(size_t i) { return -1; }
-
-        template<typename type, size_t I, std::enable_if_t<0 < I, bool> = true>
-        bool checkType(size_t i) {
-            if (I > typeArraySize || I - 1 < i) {
-                throw TypeNotAcceptedException();
-            }
-            if (I - 1 > i) {
-                return checkType<type, I - 1>(i);
-            }
-            using t = typename std::tuple_element<I - 1, typeArray>::type;
-            return typeid(type) == typeid(t);
-        }
-
-        template<typename type, size_t I, std::enable_if_t<0 == I, bool> = true>
-        bool checkType(size_t i) { return false; }
-
-        template<size_t I, std::enable_if_t<0 < I, bool> = true>
-        void deleteThem(size_t i) {
-            if (I > typeArraySize || I - 1 < i) {
-                throw TypeNotAcceptedException();
-            }
-            if (I - 1 > i) {
-                deleteThem<I - 1>(i);
-                return;
-            }
-            using t = typename std::tuple_element<I - 1, typeArray>::type;
-            Node<t> *n = static_cast<Node<t> *>(node);
-            delete n;
-            delete type;
-        }
-
-        template<size_t I, std::enable_if_t<0 == I, bool> = true>
-        void deleteThem(size_t i) {}
-
-        template<size_t I, std::enable_if_t<0 < I, bool> = true>
-        bool equal(size_t i, Wrap &other) {
-            if (I > typeArraySize || I - 1 < i) {
-                throw TypeNotAcceptedException();
-            }
-            if (I - 1 > i) {
-                return equal<I - 1>(i, other);
-            }
-            using t = typename std::tuple_element<I - 1, typeArray>::type;
-            Node<t> *n1 = static_cast<Node<t> *>(node), *n2 = static_cast<Node<t> *>(other.getNode());
-            return *n1 == *n2;
-        }
-
-        template<size_t I, std::enable_if_t<0 == I, bool> = true>
-        bool equal(size_t i, Wrap &other) {
-            return false;
-        }
-    };
-
-    using typeArray = std::tuple<types...>;
     static constexpr size_t typeArraySize = sizeof...(types);
+    // user space addresses fit in 48 bits, the index of the type goes into the 16 above them
+    static constexpr unsigned TAG_SHIFT = 48;
+    static constexpr uintptr_t ADDRESS_MASK = (uintptr_t(1) << TAG_SHIFT) - 1;
+    static_assert(sizeof(uintptr_t) == 8, "tagged pointers need 64 bit addresses");
+    static_assert(typeArraySize < (1 << (64 - TAG_SHIFT)), "too many types for the tag");
+
+    // every element is one word in list, its address tagged with the index of its type, 0 is an empty slot,
+    // collisions are resolved by linear probing, so adding allocates nothing
     size_t capacity = 0;
     size_t size = 0;
-    Wrap **list;
+    uintptr_t *list;
 public:
     explicit UniqueCombinedSet(size_t startingCapacity = 10) {
-        list = new Wrap *[startingCapacity]{nullptr};
+        list = new uintptr_t[startingCapacity]{0};
         capacity = startingCapacity;
     };
 
     class Iterator {
         friend UniqueCombinedSet<types...>;
 
-        Wrap *wrapper;
-        size_t i;
         UniqueCombinedSet<types...> set;
-        Wrap *last;
-        bool end = false;
+        size_t i;
     public:
-        explicit Iterator(UniqueCombinedSet<types...> set) : wrapper(nullptr), i(0), set(set) {
-            Wrap *w = nullptr;
-            for (int j = 0; j < set.capacity; j++) {
-                if (set.list[j] != nullptr) {
-                    w = set.list[j];
-                    if (wrapper == nullptr) {
-                        i = j;
-                        wrapper = set.list[j];
-                    }
-                }
-            }
-            if (w != nullptr) {
-                while (w->getNext() != nullptr) {
-                    w = w->getNext();
-                }
-            } else {
-                end = true;
-            }
-            last = w;
+        explicit Iterator(UniqueCombinedSet<types...> set) : set(set), i(0) {
+            skipEmpty();
         }
 
         void operator++() {
-            if (i >= (int) set.capacity || i < 0) {
+            if (i >= set.capacity) {
                 throw IndexOutOfRangeException();
             }
-            if (wrapper == nullptr) {
-                i++;
-                if (i >= set.capacity) {
-                    return;
-                }
-                wrapper = set.list[i];
-            } else {
-                wrapper = wrapper->getNext();
-            }
-            if (wrapper == nullptr) {
-                ++(*this);
-            }
+            i++;
+            skipEmpty();
         };
 
         template<typename type>
-        type getData() { return (wrapper != nullptr) ? wrapper->template getData<type>() : throw EmptySetException(); }
-
-        bool finished() {
-            if (end) {
-                return false;
+        type getData() {
+            if (i >= set.capacity) {
+                throw EmptySetException();
             }
-            if (wrapper == last) {
-                end = true;
+            if (tagOf(set.list[i]) != indexOf<type>()) {
+                throw WrongTypeException();
             }
-            return true;
-        };
+            return *addressOf<type>(set.list[i]);
+        }
+        // the element itself instead of a copy
+        template<typename type>
+        type *getPointer() {
+            if (i >= set.capacity) {
+                throw EmptySetException();
+            }
+            if (tagOf(set.list[i]) != indexOf<type>()) {
+                throw WrongTypeException();
+            }
+            return addressOf<type>(set.list[i]);
+        }
+
+        bool finished() { return i < set.capacity; };
 
     private:
-        Wrap *getWrapper() { return wrapper; }
+        uintptr_t getWord() { return set.list[i]; }
+
+        void skipEmpty() {
+            while (i < set.capacity && set.list[i] == 0) {
+                i++;
+            }
+        };
     };
 
     friend Iterator;
@@ -217,10 +90,12 @@ public:
     }
 
     UniqueCombinedSet<types...> setUnion(UniqueCombinedSet<types...> otherSet) {
-        UniqueCombinedSet<types...> newSet{otherSet};
+        UniqueCombinedSet<types...> newSet(otherSet.capacity);
+        for (auto iter = otherSet.getIterator(); iter.finished(); ++iter) {
+            newSet.addWord(iter.getWord());
+        }
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            newSet.CopyNodeValueAndAddIt<newSet.typeArraySize>(iter.getWrapper()->getType()->getTypeId(),
-                                                               iter.getWrapper()->getNode());
+            newSet.addWord(iter.getWord());
         }
         return newSet;
     };
@@ -228,9 +103,8 @@ public:
     UniqueCombinedSet<types...> setIntersection(UniqueCombinedSet<types...> otherSet) {
         UniqueCombinedSet<types...> newSet;
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            if (otherSet.containsWrapper(iter.getWrapper())) {
-                newSet.CopyNodeValueAndAddIt<newSet.typeArraySize>(iter.getWrapper()->getType()->getTypeId(),
-                                                                   iter.getWrapper()->getNode());
+            if (otherSet.containsWord(iter.getWord())) {
+                newSet.addWord(iter.getWord());
             }
         }
         return newSet;
@@ -241,7 +115,7 @@ public:
             return false;
         }
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            if (!otherSet.containsWrapper(iter.getWrapper())) {
+            if (!otherSet.containsWord(iter.getWord())) {
                 return false;
             }
         }
@@ -250,7 +124,7 @@ public:
 
     bool operator<(UniqueCombinedSet<types...> otherSet) {
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            if (!otherSet.containsWrapper(iter.getWrapper())) {
+            if (!otherSet.containsWord(iter.getWord())) {
                 return false;
             }
         }
@@ -265,15 +139,7 @@ public:
     bool operator>=(UniqueCombinedSet<types...> otherSet) { return *this > otherSet || *this == otherSet; };
 
     void clear() {
-        Wrap *w = nullptr;
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            delete w;
-            w = iter.getWrapper();
-        }
-        delete w;
-        for (int i = 0; i < capacity; i++) {
-            list[i] = nullptr;
-        }
+        std::fill(list, list + capacity, 0);
         size = 0;
     };
 
@@ -285,56 +151,31 @@ public:
 
     template<typename type>
     void add(type &value) {
-        size_t key = hash(value);
-        type *val = &value;
-        Type *newType = new Type(getTypeId<type>());
-        Node<type> *newNode = new Node<type>(val, key);
-        Wrap *wrapper = new Wrap(newNode, newType);
-        addToList(wrapper, key % capacity);
+        addWord(wordOf(value));
     };
 
     template<typename type>
     void remove(type &value) {
-        size_t key = hash(value);
-        type *val = &value;
-        Type *t = new Type(getTypeId<type>());
-        Node<type> *n = new Node<type>(val, key);
-        Wrap *wrapper = list[key % capacity], *w = nullptr, *wrapperToRemove = new Wrap(n, t);
-        while (wrapper != nullptr) {
-            if (*wrapper == *wrapperToRemove) {
-                if (w == nullptr) {
-                    list[key % capacity] = nullptr;
-                } else {
-                    w->setNext(wrapper->getNext());
-                }
-                delete wrapper;
-                delete wrapperToRemove;
-                size--;
-                return;
+        size_t slot = locate(wordOf(value));
+        if (list[slot] == 0) {
+            throw ValueNotFoundException();
+        }
+        size_t hole = slot; // shift back the words that probed past the hole
+        for (size_t next = (hole + 1) % capacity; list[next] != 0; next = (next + 1) % capacity) {
+            size_t home = homeOf(list[next]);
+            if ((next + capacity - home) % capacity >= (next + capacity - hole) % capacity) {
+                list[hole] = list[next];
+                hole = next;
             }
-            w = wrapper;
-            wrapper = wrapper->getNext();
         }
-        delete wrapperToRemove;
-        throw ValueNotFoundException();
+        list[hole] = 0;
+        size--;
     }
 
+    // probes compare one word, address and type at once
     template<typename type>
     bool contains(type &value) {
-        size_t key = hash(value);
-        type *val = &value;
-        Type *t = new Type(getTypeId<type>());
-        Node<type> *n = new Node<type>(val, key);
-        Wrap *wrapper = list[key % capacity], *wrapperToFind = new Wrap(n, t);
-        while (wrapper != nullptr) {
-            if (*wrapper == *wrapperToFind) {
-                delete wrapperToFind;
-                return true;
-            }
-            wrapper = wrapper->getNext();
-        }
-        delete wrapper;
-        return false;
+        return containsWord(wordOf(value));
     };
 
     size_t getSize() { return size; }
@@ -344,91 +185,67 @@ private:
 
     void addMultiple() {};
 
+    // position of type in types, typeArraySize if the set does not accept it, known at compile time
+    template<typename typeToFind>
+    static constexpr size_t indexOf() {
+        constexpr bool matches[] = {std::is_same<typeToFind, types>::value...};
+        for (size_t i = 0; i < typeArraySize; i++) {
+            if (matches[i]) {
+                return i;
+            }
+        }
+        return typeArraySize;
+    };
+
+    template<typename type>
+    uintptr_t wordOf(type &value) {
+        if constexpr (indexOf<type>() == typeArraySize) {
+            throw TypeNotAcceptedException();
+        }
+        return reinterpret_cast<uintptr_t>(&value) | (uintptr_t(indexOf<type>()) << TAG_SHIFT);
+    };
+    static size_t tagOf(uintptr_t word) { return word >> TAG_SHIFT; };
     template<typename type>
-    size_t hash(type &value) {return reinterpret_cast<size_t>(&value);}
+    static type *addressOf(uintptr_t word) { return reinterpret_cast<type *>(word & ADDRESS_MASK); };
+
+    // addresses are aligned, so the low bits are mostly zero and are mixed in by a multiplication first
+    size_t homeOf(uintptr_t word) { return ((word * 0x9E3779B97F4A7C15ull) >> 32) % capacity; };
 
-    template<typename typeToFind, size_t I = 0, std::enable_if_t<I < typeArraySize, bool> = true>
-    size_t getTypeId() {
-        using t = typename std::tuple_element<I, typeArray>::type;
-        if (typeid(typeToFind) == typeid(t)) {
-            return I;
+    // slot holding word, or the empty one where it would go
+    size_t locate(uintptr_t word) {
+        size_t slot = homeOf(word);
+        while (list[slot] != 0 && list[slot] != word) {
+            slot = (slot + 1) % capacity;
         }
-        return getTypeId<typeToFind, I + 1>();
+        return slot;
     };
 
-    template<typename typeToFind, size_t I = 0, std::enable_if_t<typeArraySize <= I, bool> = true>
-    size_t getTypeId() {
-        throw TypeNotAcceptedException();
+    bool containsWord(uintptr_t word) {
+        return list[locate(word)] != 0;
     };
 
-    void addToList(Wrap *wrapperToAdd, const size_t &position) {
-        Wrap *wrapper = list[position];
-        if (wrapper == nullptr) {
-            list[position] = wrapperToAdd;
-            size++;
-            return;
-        }
-        if (*wrapper == *wrapperToAdd) {
-            delete wrapperToAdd;
+    void addWord(uintptr_t word) {
+        size_t slot = locate(word);
+        if (list[slot] != 0) {
             return;
         }
-        while (wrapper->getNext() != nullptr) {
-            wrapper = wrapper->getNext();
-            if (*wrapper == *wrapperToAdd) {
-                delete wrapperToAdd;
-                return;
-            }
-        }
-        wrapper->setNext(wrapperToAdd);
+        list[slot] = word;
         size++;
-        if (size / capacity >= RESIZE_AT) {
+        if (size > capacity * RESIZE_AT) {
             resize(capacity * MULTIPLY_SIZE_BY);
         }
     };
 
-    void resize(const int &newCapacity) {
-        Wrap **oldList = list;
-        list = new Wrap *[newCapacity]{nullptr};
+    void resize(const size_t &newCapacity) {
+        uintptr_t *oldList = list;
         size_t oldCapacity = capacity;
+        list = new uintptr_t[newCapacity]{0};
         capacity = newCapacity;
-        size = 0;
-        Wrap *wrapper = nullptr, *w = nullptr;
-        for (int i = 0; i < oldCapacity; i++) {
-            wrapper = oldList[i];
-            while (wrapper != nullptr) {
-                CopyNodeValueAndAddIt<typeArraySize>(wrapper->getType()->getTypeId(), wrapper->getNode());
-                w = wrapper;
-                wrapper = wrapper->getNext();
-                delete w;
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldList[i] != 0) {
+                list[locate(oldList[i])] = oldList[i];
             }
         }
+        delete[] oldList;
     };
-
-    bool containsWrapper(Wrap *wrapperToFind) {
-        Wrap *wrapper = list[wrapperToFind->getKey() % capacity];
-        while (wrapper != nullptr) {
-            if (*wrapper == *wrapperToFind) {
-                return true;
-            }
-            wrapper = wrapper->getNext();
-        }
-        return false;
-    }
-
-    template<size_t I, std::enable_if_t<0 < I, bool> = true>
-    void CopyNodeValueAndAddIt(size_t i, void *node) {
-        if (I > typeArraySize || I - 1 < i) {
-            throw TypeNotAcceptedException();
-        }
-        if (I - 1 > i) {
-            return CopyNodeValueAndAddIt<I - 1>(i, node);
-        }
-        using t = typename std::tuple_element<I - 1, typeArray>::type;
-        Node<t> *n = static_cast<Node<t> *>(node);
-        t *data = n->getDataPointer();
-        add<t>(*data);
-    };
-
-    template<size_t I, std::enable_if_t<0 == I, bool> = true>
-    void CopyNodeValueAndAddIt(size_t i, void *node) {};
 };
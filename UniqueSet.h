@@ -6,91 +6,62 @@
 #include <cmath>
 #include <stdexcept>
 #include <type_traits>
+#include <algorithm>
 #include "Exceptions.h"
+#include "ArrayView.h"
 
 template<typename type> class UniqueSet {
     const float RESIZE_AT = 0.75;
     const int MULTIPLY_SIZE_BY = 2;
 
-    class Node {
-        type* data;
-        size_t key;
-        Node *next = nullptr;
-    public:
-        Node(type* data, size_t key) : data(data), key(key) {};
-        bool operator==(Node &node) {return key == node.key;};
-        type getData() {return *data;};
-        type* getDataPointer() {return data;}
-        size_t getKey() {return key;};
-        Node *getNext() {return next;};
-        void setNext(Node *node) {(next == nullptr) ? next=node : throw OccupiedSpaceException();};
-    };
+    // low bits of addresses of type are always zero
+    static constexpr unsigned ALIGNMENT_BITS = alignof(type) >= 16 ? 4 : alignof(type) >= 8 ? 3 : alignof(type) >= 4 ? 2 : alignof(type) >= 2 ? 1 : 0;
+
+    // the element is its address, so the table holds only pointers, nullptr is an empty slot and collisions are
+    // resolved by linear probing
     size_t capacity = 0;
     size_t size = 0;
-    Node **list; // list -> bucket
+    type **list;
 public:
     explicit UniqueSet(size_t startingCapacity = 10) {
-        list = new Node* [startingCapacity] {nullptr};
+        list = new type* [startingCapacity] {nullptr};
         capacity = startingCapacity;
     };
 
     class Iterator {
         friend UniqueSet<type>;
 
-        Node *node;
-        size_t i;
         UniqueSet<type> set;
-        Node *last;
-        bool end = false;
+        size_t i;
     public:
-        explicit Iterator(UniqueSet<type> set) : node(nullptr), i(0), set(set) {
-            Node* n = nullptr;
-            for (int j = 0; j < set.capacity; j++) {
-                if (set.list[j] != nullptr) {
-                    n = set.list[j];
-                    if (node == nullptr) {
-                        i = j;
-                        node = set.list[j];
-                    }
-                }
-            }
-            while (n->getNext() != nullptr) {
-                n = n->getNext();
-            }
-            last = n;
+        explicit Iterator(UniqueSet<type> set) : set(set), i(0) {
+            skipEmpty();
         }
 
         void operator++() {
-            if (i >= (int) set.capacity || i < 0) {
+            if (i >= set.capacity) {
                 throw IndexOutOfRangeException();
             }
-            if (node == nullptr) {
-                i++;
-                if (i >= set.capacity) {
-                    return;
-                }
-                node = set.list[i];
-            } else {
-                node = node->getNext();
-            }
-            if (node == nullptr) {
-                ++(*this);
-            }
+            i++;
+            skipEmpty();
         };
 
-        type getData() {return node->getData();}
-        bool finished() {
-            if (end) {
-                return false;
-            }
-            if (node == last) {
-                end = true;
+        type getData() {
+            if (i >= set.capacity) {
+                throw EmptySetException();
             }
-            return true;
-        };
+            return *set.list[i];
+        }
+        bool finished() {return i < set.capacity;};
 
     private:
-        Node* getNode() {return node;}
+        type *getPointer() {return set.list[i];}
+
+        void skipEmpty() {
+            while (i < set.capacity && set.list[i] == nullptr) {
+                i++;
+            }
+        };
     };
 
     friend Iterator;
@@ -99,10 +70,12 @@ public:
     }
 
     UniqueSet<type> setUnion(UniqueSet<type> otherSet) {
-        UniqueSet<type> newSet {otherSet};
+        UniqueSet<type> newSet(otherSet.capacity);
+        for (auto iter = otherSet.getIterator(); iter.finished(); ++iter) {
+            newSet.add(*iter.getPointer());
+        }
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            type *tmp = iter.getNode()->getDataPointer();
-            newSet.add(*tmp);
+            newSet.add(*iter.getPointer());
         }
         return newSet;
     };
@@ -110,7 +83,7 @@ public:
     UniqueSet<type> setIntersection(UniqueSet<type> otherSet) {
         UniqueSet<type> newSet;
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            type *tmp = iter.getNode()->getDataPointer();
+            type *tmp = iter.getPointer();
             if (otherSet.contains(*tmp)) {
                 newSet.add(*tmp);
             }
@@ -123,8 +96,7 @@ public:
             return false;
         }
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            type *tmp = iter.getNode()->getDataPointer();
-            if (!otherSet.contains(*tmp)) {
+            if (!otherSet.contains(*iter.getPointer())) {
                 return false;
             }
         }
@@ -132,8 +104,7 @@ public:
     };
     bool operator<(UniqueSet<type> otherSet) {
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            type *tmp = iter.getNode()->getDataPointer();
-            if (!otherSet.contains(*tmp)) {
+            if (!otherSet.contains(*iter.getPointer())) {
                 return false;
             }
         }
@@ -147,63 +118,43 @@ public:
     bool operator>=(UniqueSet<type> otherSet) {return *this > otherSet || *this == otherSet;};
 
     void clear() {
-        Node *n = nullptr;
-        for (auto iter = getIterator(); iter.finished(); ++iter) {
-            delete n;
-            n = iter.getNode();
-        }
-        delete n;
-        for (int i = 0; i < capacity; i++) {
-            list[i] = nullptr;
-        }
+        std::fill(list, list + capacity, nullptr);
         size = 0;
     };
 
     template<typename... types>
-    void addMultiple(type &value, types&... values) {add(*(&value)); addMultiple(values...);};
+    void addMultiple(type &value, types&... values) {add(value); addMultiple(values...);};
     void add(type &value) {
-        size_t key = hash(value);
-        type *val = &value;
-        Node *newNode = new Node(val, key);
-        addToList(newNode, key%capacity);
+        size_t slot = locate(&value);
+        if (list[slot] != nullptr) {
+            return;
+        }
+        list[slot] = &value;
+        size++;
+        if (size > capacity * RESIZE_AT) {
+            resize(capacity * MULTIPLY_SIZE_BY);
+        }
     };
 
     void remove(type &value) {
-        size_t key = hash(value);
-        type *val = &value;
-        Node *node = list[key%capacity], *n = nullptr, *nodeToRemove = new Node(val, key);
-        while (node != nullptr) {
-            if (*node == *nodeToRemove) {
-                if (n == nullptr) {
-                    list[key%capacity] = nullptr;
-                } else {
-                    n->setNext(node->getNext());
-                }
-                delete node;
-                delete nodeToRemove;
-                size--;
-                return;
+        size_t slot = locate(&value);
+        if (list[slot] == nullptr) {
+            throw ValueNotFoundException();
+        }
+        size_t hole = slot; // shift back the pointers that probed past the hole
+        for (size_t next = (hole + 1) % capacity; list[next] != nullptr; next = (next + 1) % capacity) {
+            size_t home = hash(list[next]);
+            if ((next + capacity - home) % capacity >= (next + capacity - hole) % capacity) {
+                list[hole] = list[next];
+                hole = next;
             }
-            n = node;
-            node = node->getNext();
         }
-        delete nodeToRemove;
-        throw ValueNotFoundException();
+        list[hole] = nullptr;
+        size--;
     }
 
     bool contains(type &value) {
-        size_t key = hash(value);
-        type *val = &value;
-        Node *node = list[key%capacity], *nodeToFind = new Node(val, key);
-        while (node != nullptr) {
-            if (*node == *nodeToFind) {
-                delete nodeToFind;
-                return true;
-            }
-            node = node->getNext();
-        }
-        delete nodeToFind;
-        return false;
+        return list[locate(&value)] != nullptr;
     };
 
     size_t getSize() {return size;}
@@ -212,59 +163,62 @@ public:
         type *listToReturn = new type[size];
         int i = 0;
         for (auto iter = getIterator(); iter.finished(); ++iter) {
-            listToReturn[i] = *iter.getNode()->getDataPointer();
+            listToReturn[i] = *iter.getPointer();
             i++;
         }
         return listToReturn;
     };
+    // the table itself, nullptr in empty slots, valid until the next add or remove
+    ArrayView<type *> getSlots() {return ArrayView<type *>(list, capacity);};
+    // elements are the addresses, so the stored pointers are written, the objects are not copied,
+    // returns out after the last one
+    template<typename Output>
+    Output copyTo(Output out) {
+        for (size_t i = 0; i < capacity; i++) {
+            if (list[i] != nullptr) {
+                *out++ = list[i];
+            }
+        }
+        return out;
+    };
+    // returns the number of pointers written, IndexOutOfRangeException if buffer is smaller than the set
+    size_t fill(ArrayView<type *> buffer) {
+        if (buffer.getSize() < size) {
+            throw IndexOutOfRangeException();
+        }
+        copyTo(buffer.getData());
+        return size;
+    };
 
 private:
 
     void addMultiple() {};
 
-    size_t hash(type &value) { return reinterpret_cast<size_t>(&value);}; //pointer -> size_t
+    // home slot of an address, alignment bits dropped and the rest mixed by a multiplication, plain
+    // address % capacity would leave most slots unused
+    size_t hash(type *value) {
+        return (((reinterpret_cast<size_t>(value) >> ALIGNMENT_BITS) * 0x9E3779B97F4A7C15ull) >> 32) % capacity;
+    };
 
-    void addToList(Node *nodeToAdd, const size_t &position) {
-        Node *node = list[position];
-        if (node == nullptr) {
-            list[position] = nodeToAdd;
-            size++;
-            return;
-        }
-        if (*node == *nodeToAdd) {
-            delete nodeToAdd;
-            return;
-        }
-        while (node->getNext() != nullptr) {
-            node = node->getNext();
-            if (*node == *nodeToAdd) {
-                delete nodeToAdd;
-                return;
-            }
-        }
-        node->setNext(nodeToAdd);
-        size++;
-        if (size/capacity >= RESIZE_AT) {
-            resize(capacity*MULTIPLY_SIZE_BY);
+    // slot holding value, or the empty one where it would go
+    size_t locate(type *value) {
+        size_t slot = hash(value);
+        while (list[slot] != nullptr && list[slot] != value) {
+            slot = (slot + 1) % capacity;
         }
+        return slot;
     };
 
-    void resize(const int &newCapacity) {
-        Node **oldList = list;
-        list = new Node* [newCapacity] {nullptr};
+    void resize(const size_t &newCapacity) {
+        type **oldList = list;
         size_t oldCapacity = capacity;
+        list = new type* [newCapacity] {nullptr};
         capacity = newCapacity;
-        size = 0;
-        Node *node = nullptr, *n = nullptr;
-        for (int i = 0; i < oldCapacity; i++) {
-            node = oldList[i];
-            while (node != nullptr) {
-                type* temp = node->getDataPointer();
-                add(*temp);
-                n = node;
-                node = node->getNext();
-                delete n;
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldList[i] != nullptr) {
+                list[locate(oldList[i])] = oldList[i];
             }
         }
+        delete[] oldList;
     };
 };
\ No newline at end of file